@@ -0,0 +1,320 @@
+/*
+  ==============================================================================
+
+    ModulatedSVF.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "ModulatedSVF.h"
+
+void ModulatedSVF::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    numGroups = ((int) spec.numChannels + lanes - 1) / lanes;
+    states.resize((size_t) (numGroups * maxStages));
+    interleaved.resize((size_t) (numGroups * chunkSize));
+    reset();
+}
+
+void ModulatedSVF::reset()
+{
+    std::fill(states.begin(), states.end(), Integrators<Vec>{ Vec::expand(0.0f), Vec::expand(0.0f) });
+}
+
+void ModulatedSVF::setType(Type newType) noexcept
+{
+    switch (newType)
+    {
+        case Type::bandpass: output = Output::bandpass; break;
+        case Type::highpass: output = Output::highpass; break;
+        case Type::lowpass:
+        default:             output = Output::lowpass; break;
+    }
+}
+
+void ModulatedSVF::setNumStages(int newNumStages) noexcept
+{
+    newNumStages = juce::jlimit(1, maxStages, newNumStages);
+
+    //stages coming back in start from silence, not from wherever they were left
+    if (newNumStages > numStages)
+        for (int group = 0; group < numGroups; ++group)
+            for (int stage = numStages; stage < newNumStages; ++stage)
+                states[(size_t) (group * maxStages + stage)] = { Vec::expand(0.0f), Vec::expand(0.0f) };
+
+    numStages = newNumStages;
+}
+
+void ModulatedSVF::setMorph(float newPosition) noexcept
+{
+    output = Output::morph;
+    morphPosition = juce::jlimit(0.0f, maxMorph, newPosition);
+}
+
+void ModulatedSVF::setResonance(float newResonance) noexcept
+{
+    R2 = 1.0f / juce::jmax(0.01f, newResonance);
+}
+
+void ModulatedSVF::process(juce::dsp::AudioBlock<float>& block, const float* cutoffHz) noexcept
+{
+    auto numChannels = juce::jmin((int) block.getNumChannels(), numGroups * lanes);
+    auto numSamples = (int) block.getNumSamples();
+
+    updateMix();
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        auto length = juce::jmin(chunkSize, numSamples - start);
+        makeCoefficients(cutoffHz + start, length);
+        processChannels(block, numChannels, start, length);
+    }
+}
+
+void ModulatedSVF::process(juce::dsp::AudioBlock<float>& block, float cutoffHz) noexcept
+{
+    auto numChannels = juce::jmin((int) block.getNumChannels(), numGroups * lanes);
+    auto numSamples = (int) block.getNumSamples();
+
+    updateMix();
+
+    //the same coefficients for every sample, so one chunk of them does the whole block
+    makeCoefficients(&cutoffHz, 1);
+    std::fill(a1.begin() + 1, a1.end(), a1[0]);
+    std::fill(a2.begin() + 1, a2.end(), a2[0]);
+    std::fill(a3.begin() + 1, a3.end(), a3[0]);
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        auto length = juce::jmin(chunkSize, numSamples - start);
+
+        processChannels(block, numChannels, start, length);
+    }
+}
+
+void ModulatedSVF::makeCoefficients(const float* cutoffHz, int numSamples) noexcept
+{
+    auto piOverSampleRate = juce::MathConstants<float>::pi / (float) sampleRate;
+    auto maxCutoff = maxCutoffRatio * (float) sampleRate;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto cutoff = juce::jlimit(1.0f, maxCutoff, cutoffHz[i]);
+        auto gain = juce::dsp::FastMathApproximations::tan(piOverSampleRate * cutoff);
+
+        a1[(size_t) i] = 1.0f / (1.0f + gain * (R2 + gain));
+        a2[(size_t) i] = gain * a1[(size_t) i];
+        a3[(size_t) i] = gain * a2[(size_t) i];
+    }
+}
+
+void ModulatedSVF::updateMix() noexcept
+{
+    if (output != Output::morph)
+        return;
+
+    auto mix = getMix();
+    mixLowpass = mix.lowpass;
+    mixBandpass = mix.bandpass;
+    mixInput = mix.input;
+}
+
+ModulatedSVF::Mix ModulatedSVF::getMix() const noexcept
+{
+    switch (output)
+    {
+        case Output::lowpass:  return { 1.0f, 0.0f, 0.0f };
+        case Output::bandpass: return { 0.0f, 1.0f, 0.0f };
+        case Output::highpass: return { -1.0f, -R2, 1.0f };
+        case Output::morph:
+        default:               break;
+    }
+
+    //how much lowpass, bandpass, highpass and R2 * bandpass each position is
+    static constexpr float responses[][4]{
+        { 1.0f, 0.0f,  0.0f,  0.0f }, //lowpass
+        { 0.0f, 1.0f,  0.0f,  0.0f }, //bandpass
+        { 0.0f, 0.0f,  1.0f,  0.0f }, //highpass
+        { 1.0f, 0.0f,  1.0f,  0.0f }, //notch
+        { 1.0f, 0.0f, -1.0f,  0.0f }, //peak
+        { 1.0f, 0.0f,  1.0f, -1.0f }, //allpass
+    };
+
+    auto index = juce::jmin((int) morphPosition, (int) maxMorph - 1);
+    auto fraction = morphPosition - (float) index;
+    float weights[4];
+
+    for (int i = 0; i < 4; ++i)
+        weights[i] = responses[index][i] + fraction * (responses[index + 1][i] - responses[index][i]);
+
+    //swap the highpass for input - R2 * bandpass - lowpass
+    return { weights[0] - weights[2], weights[1] + (weights[3] - weights[2]) * R2, weights[2] };
+}
+
+std::complex<double> ModulatedSVF::getResponse(double frequencyHz, double cutoffHz, double sampleRateToUse) const noexcept
+{
+    //the TPT filter is the analog one through the bilinear transform with the cutoff prewarped,
+    //so at frequencyHz its s (scaled so the cutoff is 1) is j * tan(pi f / fs) / tan(pi fc / fs)
+    auto piOverSampleRate = juce::MathConstants<double>::pi / sampleRateToUse;
+    auto cutoff = juce::jlimit(1.0, (double) maxCutoffRatio * sampleRateToUse, cutoffHz);
+    auto frequency = juce::jlimit(0.0, 0.4999 * sampleRateToUse, frequencyHz);
+    auto s = std::complex<double>(0.0, std::tan(piOverSampleRate * frequency) / std::tan(piOverSampleRate * cutoff));
+
+    auto denominator = s * s + (double) R2 * s + 1.0;
+    auto lowpass = 1.0 / denominator;
+    auto bandpass = s / denominator;
+
+    auto mix = getMix();
+    auto stage = (double) mix.lowpass * lowpass + (double) mix.bandpass * bandpass + (double) mix.input;
+
+    return std::pow(stage, numStages);
+}
+
+void ModulatedSVF::processChannels(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept
+{
+    switch (output)
+    {
+        case Output::bandpass: processChannels<Output::bandpass>(block, numChannels, start, numSamples); break;
+        case Output::highpass: processChannels<Output::highpass>(block, numChannels, start, numSamples); break;
+        case Output::morph:    processChannels<Output::morph>(block, numChannels, start, numSamples); break;
+        case Output::lowpass:
+        default:               processChannels<Output::lowpass>(block, numChannels, start, numSamples); break;
+    }
+}
+
+template <ModulatedSVF::Output response>
+void ModulatedSVF::processChannels(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept
+{
+    static_assert(maxStages == 4, "add a case for each number of stages");
+
+    switch (numStages)
+    {
+        case 2:  processChannels<response, 2>(block, numChannels, start, numSamples); break;
+        case 3:  processChannels<response, 3>(block, numChannels, start, numSamples); break;
+        case 4:  processChannels<response, 4>(block, numChannels, start, numSamples); break;
+        case 1:
+        default: processChannels<response, 1>(block, numChannels, start, numSamples); break;
+    }
+}
+
+template <ModulatedSVF::Output response, int stages>
+void ModulatedSVF::processChannels(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept
+{
+    if (numChannels < minChannelsForLanes)
+    {
+        processPairs<response, stages>(block, numChannels, start, numSamples);
+        return;
+    }
+
+    interleave(block, numChannels, start, numSamples);
+    processGroups<response, stages>((numChannels + lanes - 1) / lanes, numSamples);
+    deinterleave(block, numChannels, start, numSamples);
+}
+
+void ModulatedSVF::interleave(const juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept
+{
+    //lane c of group g is channel g * lanes + c, so in floats a sample of every channel is one row
+    auto* rows = reinterpret_cast<float*>(interleaved.data());
+    auto rowLength = numGroups * lanes;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* samples = block.getChannelPointer((size_t) channel) + start;
+
+        for (int i = 0; i < numSamples; ++i)
+            rows[i * rowLength + channel] = samples[i];
+    }
+
+    //lanes past the block's last channel get silence rather than whatever was left in them
+    auto numLanesUsed = (numChannels + lanes - 1) / lanes * lanes;
+
+    for (int channel = numChannels; channel < numLanesUsed; ++channel)
+        for (int i = 0; i < numSamples; ++i)
+            rows[i * rowLength + channel] = 0.0f;
+}
+
+void ModulatedSVF::deinterleave(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) const noexcept
+{
+    auto* rows = reinterpret_cast<const float*>(interleaved.data());
+    auto rowLength = numGroups * lanes;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* samples = block.getChannelPointer((size_t) channel) + start;
+
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = rows[i * rowLength + channel];
+    }
+}
+
+template <ModulatedSVF::Output response, int stages>
+void ModulatedSVF::processGroups(int numActiveGroups, int numSamples) noexcept
+{
+    //each sample depends on the one before, so one group on its own waits on that chain of
+    //multiplies. two at a time keeps both chains going at once, which nearly doubles throughput
+    int group = 0;
+
+    for (; group + 1 < numActiveGroups; group += 2)
+    {
+        auto a = getStates<stages>(group);
+        auto b = getStates<stages>(group + 1);
+        auto* row = interleaved.data() + group;
+
+        for (size_t i = 0; i < (size_t) numSamples; ++i, row += numGroups)
+        {
+            row[0] = tickStages<response>(a, row[0], i);
+            row[1] = tickStages<response>(b, row[1], i);
+        }
+
+        setStates(group, a);
+        setStates(group + 1, b);
+    }
+
+    if (group < numActiveGroups)
+    {
+        auto a = getStates<stages>(group);
+        auto* row = interleaved.data() + group;
+
+        for (size_t i = 0; i < (size_t) numSamples; ++i, row += numGroups)
+            row[0] = tickStages<response>(a, row[0], i);
+
+        setStates(group, a);
+    }
+}
+
+template <ModulatedSVF::Output response, int stages>
+void ModulatedSVF::processPairs(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept
+{
+    int channel = 0;
+
+    for (; channel + 1 < numChannels; channel += 2)
+    {
+        auto* left = block.getChannelPointer((size_t) channel) + start;
+        auto* right = block.getChannelPointer((size_t) channel + 1) + start;
+        auto a = getChannelStates<stages>(channel);
+        auto b = getChannelStates<stages>(channel + 1);
+
+        for (size_t i = 0; i < (size_t) numSamples; ++i)
+        {
+            left[i] = tickStages<response>(a, left[i], i);
+            right[i] = tickStages<response>(b, right[i], i);
+        }
+
+        setChannelStates(channel, a);
+        setChannelStates(channel + 1, b);
+    }
+
+    if (channel < numChannels)
+    {
+        auto* samples = block.getChannelPointer((size_t) channel) + start;
+        auto a = getChannelStates<stages>(channel);
+
+        for (size_t i = 0; i < (size_t) numSamples; ++i)
+            samples[i] = tickStages<response>(a, samples[i], i);
+
+        setChannelStates(channel, a);
+    }
+}
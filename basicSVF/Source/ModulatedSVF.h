@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    ModulatedSVF.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    State variable filter whose cutoff can change every sample, for
+    modulating it at audio rate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Same TPT filter and output as juce::dsp::StateVariableTPTFilter, but
+    instead of working the coefficients out in setCutoffFrequency() (a
+    std::tan and a divide per call), process() takes a cutoff for every
+    sample and works out a whole chunk of coefficients in one loop.
+
+    That loop has no dependency between samples, so it vectorizes, and it
+    uses FastMathApproximations::tan (a 7/6 Pade approximant). Relative
+    error against std::tan is under 5e-7 up to 0.49 of the sample rate,
+    which is as high as the cutoff goes, so the response is the same as
+    the library filter's.
+
+    As well as the three outputs of the library filter, setMorph() gives
+    notch (low + high), peak (low - high) and allpass (low + high - R2 *
+    band), and anything in between neighbouring ones. They're all sums of
+    the same lowpass, bandpass and input, so a morphing filter costs three
+    multiplies a sample more than a plain one, not another filter.
+
+    The coefficients are shared by every channel. The channels themselves
+    go through in groups of SIMDRegister<float>::size() (4 with SSE/NEON,
+    8 with AVX): each chunk gets interleaved so one register holds the same
+    sample of every channel in a group, and the integrator states live in
+    the matching lanes, so one pass of the filter does the whole group.
+    setNumStages() puts up to four copies of the filter in series for
+    steeper slopes. The number of stages is a template parameter of the
+    processing loops, so each count is its own unrolled loop with the
+    stages' states held in registers, and process() switches to the one
+    that matches. Each group's (or channel's) states for all the stages sit
+    next to each other in memory.
+
+    Two groups go through side by side so 8 and 16 channels keep two chains
+    of multiplies going at once. Mono and stereo would fill a quarter or half
+    of a register and still pay for the interleave, so they run the same
+    filter on plain floats, two channels side by side, reading and writing
+    their states in the same lanes.
+*/
+class ModulatedSVF
+{
+public:
+    using Type = juce::dsp::StateVariableTPTFilterType;
+
+    //highest cutoff as a fraction of the sample rate, tan heads off to infinity at 0.5
+    static constexpr float maxCutoffRatio = 0.49f;
+    //morph positions run 0 lowpass, 1 bandpass, 2 highpass, 3 notch, 4 peak, 5 allpass
+    static constexpr float maxMorph = 5.0f;
+    //most filters in series, each one adds 12 dB/oct to the slope
+    static constexpr int maxStages = 4;
+
+    ModulatedSVF() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    //one of the three responses on its own
+    void setType(Type newType) noexcept;
+    //crossfade between the two responses either side of position (see maxMorph), all from the
+    //same pass of the filter. whole numbers are the responses on their own
+    void setMorph(float newPosition) noexcept;
+    //how many copies of the filter the signal goes through, 1 to maxStages
+    void setNumStages(int newNumStages) noexcept;
+    //same meaning as StateVariableTPTFilter's, 1 / sqrt(2) is flat
+    void setResonance(float newResonance) noexcept;
+
+    //filter block in place with a cutoff in Hz for every sample, shared by all the channels
+    void process(juce::dsp::AudioBlock<float>& block, const float* cutoffHz) noexcept;
+    //filter block in place with the one cutoff, the coefficients only get worked out once
+    void process(juce::dsp::AudioBlock<float>& block, float cutoffHz) noexcept;
+
+    //gain and phase of the whole filter (every stage) at frequencyHz with the cutoff held at
+    //cutoffHz, for drawing the response. only reads the settings, so it doesn't need prepare()
+    std::complex<double> getResponse(double frequencyHz, double cutoffHz, double sampleRateToUse) const noexcept;
+
+private:
+    static constexpr int chunkSize = 64;
+
+    //which output tick() returns, the three types or the morph mix
+    enum class Output
+    {
+        lowpass,
+        bandpass,
+        highpass,
+        morph,
+    };
+
+    //how much lowpass, bandpass and input make up the output
+    struct Mix
+    {
+        float lowpass, bandpass, input;
+    };
+
+    //the mix for the output, and for morph the position and resonance
+    Mix getMix() const noexcept;
+    //mixLowpass, mixBandpass and mixInput from getMix() for the morph output
+    void updateMix() noexcept;
+
+    //a1, a2 and a3 for numSamples cutoffs
+    void makeCoefficients(const float* cutoffHz, int numSamples) noexcept;
+    //filter numSamples of every channel from start, with the first numSamples coefficients.
+    //switches on the output and then the number of stages to the loop made for them
+    void processChannels(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept;
+    template <Output response>
+    void processChannels(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept;
+    template <Output response, int stages>
+    void processChannels(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept;
+
+    template <Output response, int stages>
+    void processGroups(int numActiveGroups, int numSamples) noexcept;
+    template <Output response, int stages>
+    void processPairs(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept;
+
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = (int) Vec::size();
+
+    //below this many channels interleaving costs more than filtering them one at a time saves
+    static constexpr int minChannelsForLanes = 3;
+
+    //numSamples of every channel from start into interleaved, one channel per lane, and back out
+    void interleave(const juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) noexcept;
+    void deinterleave(juce::dsp::AudioBlock<float>& block, int numChannels, int start, int numSamples) const noexcept;
+
+    template <typename T>
+    struct Integrators
+    {
+        T z1, z2;
+    };
+
+    template <typename T>
+    static T broadcast(float value) noexcept
+    {
+        if constexpr (std::is_same_v<T, Vec>)
+            return Vec::expand(value);
+        else
+            return value;
+    }
+
+    //one sample through the filter, of one channel or a group of them. the same filter as
+    //StateVariableTPTFilter's with z1 and z2 as the integrators, rearranged so it's five
+    //operations from one sample's state to the next instead of eight
+    template <Output response, typename T>
+    T tick(Integrators<T>& state, T input, size_t i) const noexcept
+    {
+        auto v3 = input - state.z2;
+        auto v1 = state.z1 * broadcast<T>(a1[i]) + v3 * broadcast<T>(a2[i]);
+        auto v2 = state.z2 + state.z1 * broadcast<T>(a2[i]) + v3 * broadcast<T>(a3[i]);
+        state.z1 = v1 + v1 - state.z1;
+        state.z2 = v2 + v2 - state.z2;
+
+        if constexpr (response == Output::lowpass)
+            return v2;
+        else if constexpr (response == Output::bandpass)
+            return v1;
+        else if constexpr (response == Output::highpass)
+            return input - v1 * broadcast<T>(R2) - v2;
+        else
+            return v2 * broadcast<T>(mixLowpass) + v1 * broadcast<T>(mixBandpass) + input * broadcast<T>(mixInput);
+    }
+
+    //one sample through every stage in turn, unrolled since stages is known here
+    template <Output response, typename T, size_t stages>
+    T tickStages(std::array<Integrators<T>, stages>& state, T input, size_t i) const noexcept
+    {
+        return tickStages<response>(state, input, i, std::make_index_sequence<stages>());
+    }
+
+    template <Output response, typename T, size_t stages, size_t... stage>
+    T tickStages(std::array<Integrators<T>, stages>& state, T input, size_t i, std::index_sequence<stage...>) const noexcept
+    {
+        ((input = tick<response>(state[stage], input, i)), ...);
+        return input;
+    }
+
+    //a group's states for the first stages stages, out of states and back in
+    template <int stages>
+    std::array<Integrators<Vec>, stages> getStates(int group) const noexcept
+    {
+        std::array<Integrators<Vec>, stages> groupStates;
+        std::copy_n(states.begin() + group * maxStages, stages, groupStates.begin());
+        return groupStates;
+    }
+
+    template <size_t stages>
+    void setStates(int group, const std::array<Integrators<Vec>, stages>& groupStates) noexcept
+    {
+        std::copy(groupStates.begin(), groupStates.end(), states.begin() + group * maxStages);
+    }
+
+    //the same for one channel, out of its lane and back in
+    template <int stages>
+    std::array<Integrators<float>, stages> getChannelStates(int channel) const noexcept
+    {
+        std::array<Integrators<float>, stages> channelStates;
+        auto lane = (size_t) (channel % lanes);
+
+        for (int stage = 0; stage < stages; ++stage)
+        {
+            auto& groupState = states[(size_t) ((channel / lanes) * maxStages + stage)];
+            channelStates[(size_t) stage] = { groupState.z1.get(lane), groupState.z2.get(lane) };
+        }
+
+        return channelStates;
+    }
+
+    template <size_t stages>
+    void setChannelStates(int channel, const std::array<Integrators<float>, stages>& channelStates) noexcept
+    {
+        auto lane = (size_t) (channel % lanes);
+
+        for (size_t stage = 0; stage < stages; ++stage)
+        {
+            auto& groupState = states[(size_t) (channel / lanes) * (size_t) maxStages + stage];
+            groupState.z1.set(lane, channelStates[stage].z1);
+            groupState.z2.set(lane, channelStates[stage].z2);
+        }
+    }
+
+    double sampleRate{ 44100.0 };
+    Output output{ Output::lowpass };
+    //1 / resonance
+    float R2{ juce::MathConstants<float>::sqrt2 };
+
+    float morphPosition{ 0.0f };
+    //highpass is input - R2 * bandpass - lowpass, so the morph output is these times lowpass,
+    //bandpass and the input
+    float mixLowpass{ 1.0f }, mixBandpass{ 0.0f }, mixInput{ 0.0f };
+
+    int numStages{ 1 };
+
+    //integrator states, one register per group of lanes channels per stage:
+    //states[group * maxStages + stage]
+    std::vector<Integrators<Vec>> states;
+    int numGroups{ 0 };
+
+    //chunkSize samples of every group, sample by sample: interleaved[i * numGroups + group]
+    std::vector<Vec> interleaved;
+
+    //coefficients for a chunk of samples, with g = tan(pi * cutoff / sampleRate):
+    //a1 = 1 / (1 + g * (R2 + g)), a2 = g * a1, a3 = g * a2
+    std::array<float, chunkSize> a1{};
+    std::array<float, chunkSize> a2{};
+    std::array<float, chunkSize> a3{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModulatedSVF)
+};
@@ -11,11 +11,14 @@
 
 //==============================================================================
 BasicSVFAudioProcessorEditor::BasicSVFAudioProcessorEditor (BasicSVFAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), parameterEditor (p), responseDisplay (p)
 {
+    addAndMakeVisible(parameterEditor);
+    addAndMakeVisible(responseDisplay);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (950, 400);
 }
 
 BasicSVFAudioProcessorEditor::~BasicSVFAudioProcessorEditor()
@@ -27,14 +30,15 @@ void BasicSVFAudioProcessorEditor::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    g.setColour (juce::Colours::white);
-    g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
 }
 
 void BasicSVFAudioProcessorEditor::resized()
 {
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
+    //parameters down the left, the response takes the rest
+    auto bounds = getLocalBounds().reduced(10);
+    parameterEditor.setBounds(bounds.removeFromLeft(350));
+    bounds.removeFromLeft(10);
+    responseDisplay.setBounds(bounds);
 }
@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "ResponseDisplay.h"
 
 //==============================================================================
 /**
@@ -29,5 +30,14 @@ private:
     // access the processor object that created it.
     BasicSVFAudioProcessor& audioProcessor;
 
+    //PARAMETERS
+    //a slider, box or button for every parameter in the processor's table, so they all stay
+    //reachable as the table grows. it scrolls when they don't all fit
+    juce::GenericAudioProcessorEditor parameterEditor;
+
+    //RESPONSE DISPLAY
+    //magnitude and phase of the filter, drawn off the message thread
+    ResponseDisplay responseDisplay;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BasicSVFAudioProcessorEditor)
 };
@@ -16,16 +16,20 @@ BasicSVFAudioProcessor::BasicSVFAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
-                       )
+                       ), apvts (*this, nullptr, "Parameters", ParameterTable::createLayout(parameterTable))
 #endif
 {
+    apvts.addParameterListener("ENVLOOKAHEAD", this);
 }
 
 BasicSVFAudioProcessor::~BasicSVFAudioProcessor()
 {
+    apvts.removeParameterListener("ENVLOOKAHEAD", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -99,7 +103,42 @@ void BasicSVFAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     spec.sampleRate = sampleRate;
     spec.numChannels = getTotalNumOutputChannels();
 
-    filter.prepare(spec);
+    //wide layouts get split into parts, each prepared for its own channels
+    auto numChannels = (int) spec.numChannels;
+    numFilterParts = numChannels >= minParallelChannels ? juce::jmin(ChannelWorkers::maxTasks, (numChannels + channelsPerPart - 1) / channelsPerPart) : 1;
+
+    for (int part = 0; part < numFilterParts; ++part)
+    {
+        auto partSpec = spec;
+        partSpec.numChannels = (juce::uint32) (numFilterParts == 1 ? numChannels : juce::jmin(channelsPerPart, numChannels - part * channelsPerPart));
+        filters[(size_t) part].prepare(partSpec);
+    }
+
+    //the workers spin between blocks, so they only get started when there's something for them
+    if (numFilterParts > 1)
+        workers.start(ChannelWorkers::getAvailableWorkers());
+    else
+        workers.stop();
+
+    cutoffSmoothed.reset(sampleRate, 0.02);
+    cutoffSmoothed.setCurrentAndTargetValue(paramValues.get(Param::Cutoff));
+    morphSmoothed.reset(sampleRate, 0.02);
+    morphSmoothed.setCurrentAndTargetValue(paramValues.get(Param::Morph));
+
+    filterType = paramValues.getChoice<FilterType>(Param::Type);
+    setType();
+    forEachFilter([this] (ModulatedSVF& filter) { filter.setNumStages(paramValues.getInt(Param::Slope) + 1); });
+
+    bank.prepare(spec);
+    bank.setEnvelope(2.0f, 40.0f);
+    bankNumBands = 0;
+    bankBuffer.setSize((int) spec.numChannels, samplesPerBlock);
+
+    //room for the longest lookahead, so the message thread can change it later without anything allocating
+    lookaheadBuffer.setSize((int) spec.numChannels, (int) std::ceil(maxLookaheadMs * 0.001 * sampleRate) + 1);
+    detectorBuffer.setSize((int) spec.numChannels, (int) cutoffs.size());
+    updateLatency(sampleRate);
+    latencySamples = reportedLatency.load(std::memory_order_relaxed);
     reset();
 }
 
@@ -107,6 +146,7 @@ void BasicSVFAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    workers.stop();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -117,17 +157,24 @@ bool BasicSVFAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     return true;
   #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    //mono and stereo, and surround and ambisonic layouts up to 16 channels
+    if (! ChannelLayouts::isSupported(layouts.getMainOutputChannelSet()))
         return false;
 
     // This checks if the input layout matches the output layout
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    //the sidechain only feeds the filter bank, any of off, mono or stereo will do
+    auto sidechain = layouts.getChannelSet(true, 1);
+
+    if (! sidechain.isDisabled()
+     && sidechain != juce::AudioChannelSet::mono()
+     && sidechain != juce::AudioChannelSet::stereo())
+        return false;
    #endif
 
     return true;
@@ -150,14 +197,63 @@ void BasicSVFAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    filter.setCutoffFrequency(150.0f);
+    //alias for audio buffer needed for dsp processing. only the main bus, the sidechain's
+    //channels come after its in buffer
+    auto mainBuffer = getBusBuffer(buffer, false, 0);
+    auto audioBlock = juce::dsp::AudioBlock<float>(mainBuffer);
+    auto sidechainBuffer = getBusCount(true) > 1 ? getBusBuffer(buffer, true, 1) : juce::AudioBuffer<float>();
+    auto sidechainBlock = juce::dsp::AudioBlock<float>(sidechainBuffer);
+
+    //the lookahead changes length between blocks, once the message thread has told the host about it.
+    //the ring is at most maxLookaheadMs long, so clearing it is quick
+    auto newLatency = reportedLatency.load(std::memory_order_relaxed);
+
+    if (newLatency != latencySamples)
+    {
+        latencySamples = newLatency;
+        lookaheadBuffer.clear();
+        lookaheadPosition = 0;
+    }
+
+    //the filter gets set up again every slice (32 samples, or up to the next MIDI event), so
+    //automating the cutoff sweeps smoothly whatever size the host's buffer is
+    scheduler.process(buffer.getNumSamples(), midiMessages, [&] (int startSample, int numSamples)
+    {
+        //load in parameter states. steeper slopes are more filters in series inside the one ModulatedSVF
+        forEachFilter([this] (ModulatedSVF& filter)
+        {
+            filter.setResonance(paramValues.get(Param::Resonance));
+            filter.setNumStages(paramValues.getInt(Param::Slope) + 1);
+        });
+
+        auto newType = paramValues.getChoice<FilterType>(Param::Type);
 
-    //alias for audio buffer needed for dsp processing
-    auto audioBlock = juce::dsp::AudioBlock<float>(buffer);
-    //ProcessContextReplacing replaces incoming audio with dsp-processed audio
-    auto context = juce::dsp::ProcessContextReplacing<float>(audioBlock);
+        if (newType != filterType)
+        {
+            filterType = newType;
+            setType();
+        }
 
-    filter.process(context);
+        //the morph moves a slice at a time, in steps small enough not to click
+        morphSmoothed.setTargetValue(paramValues.get(Param::Morph));
+
+        if (filterType == FilterType::Morph)
+            forEachFilter([this] (ModulatedSVF& filter) { filter.setMorph(morphSmoothed.getCurrentValue()); });
+
+        morphSmoothed.skip(numSamples);
+
+        //sub block points into the same buffer, nothing gets copied
+        auto slice = audioBlock.getSubBlock((size_t) startSample, (size_t) numSamples);
+
+        //cutoff per sample while it's gliding or the LFO or envelope is on, otherwise the coefficients
+        //are worked out once. with a lookahead the envelope follower reads the input before it's delayed
+        auto detector = latencySamples > 0 ? delayForLookahead(slice) : slice;
+        auto modulated = updateCutoffs(detector);
+        processFilter(slice, modulated);
+
+        processBank(slice, sidechainBlock.getNumChannels() > 0 ? sidechainBlock.getSubBlock((size_t) startSample, (size_t) numSamples)
+                                                               : juce::dsp::AudioBlock<float>());
+    });
 }
 
 //==============================================================================
@@ -177,12 +273,22 @@ void BasicSVFAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     // You should use this method to store your parameters in the memory block.
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
+
+    auto state = apvts.copyState();
+    std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    copyXmlToBinary(*xml, destData);
 }
 
 void BasicSVFAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
+
+    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+
+    if (xmlState.get() != nullptr)
+        if (xmlState->hasTagName(apvts.state.getType()))
+            apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
 }
 
 //==============================================================================
@@ -194,30 +300,257 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 
 void BasicSVFAudioProcessor::reset()
 {
-    filter.reset();
+    forEachFilter([] (ModulatedSVF& filter) { filter.reset(); });
+    scheduler.reset();
+
+    envelope = 0.0f;
+    lookaheadBuffer.clear();
+    lookaheadPosition = 0;
+}
+
+bool BasicSVFAudioProcessor::updateCutoffs(const juce::dsp::AudioBlock<float>& slice)
+{
+    auto numSamples = (int) slice.getNumSamples();
+    auto numChannels = (int) slice.getNumChannels();
+
+    //slices never go past the scheduler's grid
+    jassert(numSamples <= (int) cutoffs.size());
+
+    cutoffSmoothed.setTargetValue(paramValues.get(Param::Cutoff));
+
+    auto depth = paramValues.get(Param::LfoDepth);
+    auto envelopeDepth = paramValues.get(Param::EnvDepth);
+    auto phaseStep = paramValues.get(Param::LfoRate) / (float) getSampleRate();
+    auto gliding = cutoffSmoothed.fill(cutoffs.data(), numSamples);
+
+    if (depth <= 0.0f && envelopeDepth == 0.0f)
+    {
+        //the LFO keeps going so turning it up doesn't jump, the envelope starts again from nothing
+        lfoPhase = std::fmod(lfoPhase + phaseStep * (float) numSamples, 1.0f);
+        envelope = 0.0f;
+        return gliding;
+    }
+
+    if (! gliding)
+        std::fill(cutoffs.begin(), cutoffs.begin() + numSamples, cutoffSmoothed.getCurrentValue());
+
+    //fraction of the way to the level the envelope moves each sample
+    auto coefficient = [this] (float ms) { return 1.0f - std::exp(-1000.0f / (ms * (float) getSampleRate())); };
+    auto attack = coefficient(paramValues.get(Param::EnvAttack));
+    auto release = coefficient(paramValues.get(Param::EnvRelease));
+    auto rms = paramValues.getChoice<Detector>(Param::EnvDetector) == Detector::RMS;
+
+    //detector, envelope, LFO and cutoff in the one pass over the slice. the detector takes the
+    //loudest channel (peak) or the mean square of them all (RMS), so every channel moves together
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto level = 0.0f;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto sample = slice.getChannelPointer((size_t) channel)[i];
+            level = rms ? level + sample * sample : juce::jmax(level, std::abs(sample));
+        }
+
+        if (rms)
+            level /= (float) juce::jmax(1, numChannels);
+
+        envelope += (level > envelope ? attack : release) * (level - envelope);
+        auto amplitude = juce::jmin(1.0f, rms ? std::sqrt(envelope) : envelope);
+
+        //FastMathApproximations::sin wants -pi to pi
+        auto lfo = juce::dsp::FastMathApproximations::sin(juce::MathConstants<float>::twoPi * lfoPhase - juce::MathConstants<float>::pi);
+        cutoffs[(size_t) i] *= std::exp2(depth * lfo + envelopeDepth * amplitude);
+
+        lfoPhase += phaseStep;
+        lfoPhase -= (float) (int) lfoPhase;
+    }
+
+    return true;
+}
+
+juce::dsp::AudioBlock<float> BasicSVFAudioProcessor::delayForLookahead(juce::dsp::AudioBlock<float>& slice)
+{
+    auto numSamples = (int) slice.getNumSamples();
+    auto numChannels = juce::jmin((int) slice.getNumChannels(), lookaheadBuffer.getNumChannels());
+    auto ringSize = latencySamples + 1;
+
+    //each sample goes in before anything comes out, so the slice gets the one from latencySamples ago
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* samples = slice.getChannelPointer((size_t) channel);
+        auto* ring = lookaheadBuffer.getWritePointer(channel);
+        auto position = lookaheadPosition;
+
+        juce::FloatVectorOperations::copy(detectorBuffer.getWritePointer(channel), samples, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            ring[position] = samples[i];
+
+            if (++position == ringSize)
+                position = 0;
+
+            samples[i] = ring[position];
+        }
+    }
+
+    lookaheadPosition = (lookaheadPosition + numSamples) % ringSize;
+
+    return juce::dsp::AudioBlock<float>(detectorBuffer).getSubBlock(0, (size_t) numSamples).getSubsetChannelBlock(0, (size_t) numChannels);
+}
+
+void BasicSVFAudioProcessor::updateLatency(double sampleRate)
+{
+    auto lookahead = juce::roundToInt(paramValues.get(Param::EnvLookahead) * 0.001 * sampleRate);
+    lookahead = juce::jlimit(0, juce::jmax(0, lookaheadBuffer.getNumSamples() - 1), lookahead);
+
+    reportedLatency.store(lookahead, std::memory_order_relaxed);
+    setLatencySamples(lookahead);
+}
+
+void BasicSVFAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    //it can't be automated, but a host's own controls might still set it from another thread
+    triggerAsyncUpdate();
+}
+
+void BasicSVFAudioProcessor::handleAsyncUpdate()
+{
+    updateLatency(getSampleRate());
+}
+
+void BasicSVFAudioProcessor::processFilter(juce::dsp::AudioBlock<float>& slice, bool modulated)
+{
+    auto numChannels = (int) slice.getNumChannels();
+
+    auto processPart = [&] (int part)
+    {
+        auto firstChannel = part * channelsPerPart;
+
+        //one part has every channel
+        auto channels = numFilterParts == 1 ? slice
+                                            : slice.getSubsetChannelBlock((size_t) firstChannel, (size_t) juce::jmax(0, juce::jmin(channelsPerPart, numChannels - firstChannel)));
+
+        if (modulated)
+            filters[(size_t) part].process(channels, cutoffs.data());
+        else
+            filters[(size_t) part].process(channels, cutoffSmoothed.getCurrentValue());
+    };
+
+    //the parts work the same either way, so switching between them doesn't change the sound
+    if (paramValues.getBool(Param::Parallel) && (int) slice.getNumSamples() >= minParallelSamples)
+    {
+        workers.run(numFilterParts, processPart);
+        return;
+    }
+
+    for (int part = 0; part < numFilterParts; ++part)
+        processPart(part);
+}
+
+void BasicSVFAudioProcessor::processBank(juce::dsp::AudioBlock<float>& slice, const juce::dsp::AudioBlock<float>& sidechain)
+{
+    auto numBands = bankBands[paramValues.getInt(Param::BankBands)];
+    auto mix = paramValues.get(Param::BankMix);
+
+    if (numBands == 0 || mix <= 0.0f)
+    {
+        bankNumBands = 0;
+        return;
+    }
+
+    //coefficients only get worked out again when the bands or their resonance change
+    auto resonance = paramValues.get(Param::BankResonance);
+
+    if (numBands != bankNumBands || resonance != bankResonance)
+    {
+        //the bank was off, so its filters and envelopes start from silence
+        if (bankNumBands == 0)
+            bank.reset();
+
+        bank.setBands(numBands, bankLowestHz, bankHighestHz, resonance);
+        bankNumBands = numBands;
+        bankResonance = resonance;
+    }
+
+    auto wet = juce::dsp::AudioBlock<float>(bankBuffer)
+                   .getSubsetChannelBlock(0, slice.getNumChannels())
+                   .getSubBlock(0, slice.getNumSamples());
+    wet.copyFrom(slice);
+
+    if (sidechain.getNumChannels() > 0)
+        bank.process(sidechain, wet);
+    else
+        bank.process(wet);
+
+    slice.multiplyBy(1.0f - mix);
+    slice.addProductOf(wet, mix * juce::Decibels::decibelsToGain(paramValues.get(Param::BankGain)));
 }
 
 void BasicSVFAudioProcessor::setType()
+{
+    forEachFilter([this] (ModulatedSVF& filter) { setType(filter, filterType, morphSmoothed.getCurrentValue()); });
+}
+
+void BasicSVFAudioProcessor::setType(ModulatedSVF& filterToSet, FilterType type, float morph) noexcept
 {
     //so we don't have to type out the whole class structure for every filter type
     using fType = juce::dsp::StateVariableTPTFilterType;
 
-    switch (filterType)
+    switch (type)
     {
         case FilterType::LowPass:
-            filter.setType(fType::lowpass);
+            filterToSet.setType(fType::lowpass);
             break;
 
         case FilterType::BandPass:
-            filter.setType(fType::bandpass);
+            filterToSet.setType(fType::bandpass);
             break;
 
         case FilterType::HighPass:
-            filter.setType(fType::highpass);
+            filterToSet.setType(fType::highpass);
+            break;
+
+        //the rest are mixes of those three, at the matching morph positions
+        case FilterType::Notch:
+            filterToSet.setMorph(3.0f);
+            break;
+
+        case FilterType::Peak:
+            filterToSet.setMorph(4.0f);
+            break;
+
+        case FilterType::AllPass:
+            filterToSet.setMorph(5.0f);
+            break;
+
+        case FilterType::Morph:
+            filterToSet.setMorph(morph);
             break;
 
         default:
-            filter.setType(fType::lowpass);
+            filterToSet.setType(fType::lowpass);
             break;
     }
 }
+
+BasicSVFAudioProcessor::ResponseSettings BasicSVFAudioProcessor::getResponseSettings() const noexcept
+{
+    //before prepareToPlay() there's no sample rate yet, so draw it at a usual one
+    auto sampleRate = getSampleRate();
+
+    return { sampleRate > 0.0 ? sampleRate : 44100.0,
+             paramValues.get(Param::Cutoff),
+             paramValues.get(Param::Resonance),
+             paramValues.get(Param::Morph),
+             paramValues.getChoice<FilterType>(Param::Type),
+             paramValues.getInt(Param::Slope) + 1 };
+}
+
+void BasicSVFAudioProcessor::setUpFilter(ModulatedSVF& filterToSet, const ResponseSettings& settings) noexcept
+{
+    filterToSet.setResonance(settings.resonance);
+    filterToSet.setNumStages(settings.numStages);
+    setType(filterToSet, settings.type, settings.morph);
+}
@@ -9,6 +9,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../shared/ChannelLayouts.h"
+#include "../../shared/ChannelWorkers.h"
+#include "../../shared/ParameterTable.h"
+#include "../../shared/Smoothing.h"
+#include "../../shared/SubBlockScheduler.h"
+#include "ModulatedSVF.h"
+#include "SVFBank.h"
 
 //==============================================================================
 /**
@@ -17,6 +24,8 @@ class BasicSVFAudioProcessor  : public juce::AudioProcessor
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
+                             , private juce::AudioProcessorValueTreeState::Listener
+                             , private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -56,6 +65,9 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //object for adding parameters
+    juce::AudioProcessorValueTreeState apvts;
+
 private:
     //select filter type
     enum class FilterType
@@ -63,16 +75,195 @@ private:
         LowPass,
         BandPass,
         HighPass,
+        Notch,
+        Peak,
+        AllPass,
+        //crossfade between all of them with the morph parameter
+        Morph,
+    };
+
+public:
+    //the parameters the filter's response depends on (not the LFO or envelope, they move it about
+    //the cutoff), for drawing it
+    struct ResponseSettings
+    {
+        double sampleRate;
+        float cutoff, resonance, morph;
+        FilterType type;
+        int numStages;
+
+        bool operator== (const ResponseSettings& other) const noexcept
+        {
+            return sampleRate == other.sampleRate && cutoff == other.cutoff && resonance == other.resonance
+                && morph == other.morph && type == other.type && numStages == other.numStages;
+        }
+
+        bool operator!= (const ResponseSettings& other) const noexcept { return ! (*this == other); }
+    };
+
+    //only reads atomics, so any thread can call it
+    ResponseSettings getResponseSettings() const noexcept;
+    //set filterToSet up the way settings say, with the cutoff left to process() or getResponse()
+    static void setUpFilter(ModulatedSVF& filterToSet, const ResponseSettings& settings) noexcept;
+
+private:
+
+    //every parameter, order has to match parameterTable
+    enum class Param
+    {
+        Cutoff,
+        Resonance,
+        Type,
+        LfoRate,
+        LfoDepth,
+        Morph,
+        Slope,
+        BankBands,
+        BankResonance,
+        BankGain,
+        BankMix,
+        EnvDepth,
+        EnvAttack,
+        EnvRelease,
+        EnvDetector,
+        EnvLookahead,
+        Parallel,
+    };
+
+    //what the envelope follower measures, order has to match detectorChoices
+    enum class Detector
+    {
+        Peak,
+        RMS,
     };
 
+    //order has to match the FilterType enum
+    static constexpr const char* typeChoices[]{ "Low Pass", "Band Pass", "High Pass", "Notch", "Peak", "All Pass", "Morph" };
+    //index + 1 is the number of filter stages
+    static constexpr const char* slopeChoices[]{ "12 dB/oct", "24 dB/oct", "36 dB/oct", "48 dB/oct" };
+    static_assert(std::size(slopeChoices) == ModulatedSVF::maxStages, "one slope for each number of stages");
+    //number of bands in the filter bank after the filter, 0 is off
+    static constexpr const char* bankChoices[]{ "Off", "16 Bands", "32 Bands", "64 Bands" };
+    static constexpr int bankBands[]{ 0, 16, 32, 64 };
+
+    static constexpr const char* detectorChoices[]{ "Peak", "RMS" };
+    static constexpr float maxLookaheadMs = 10.0f;
+
+    //range the bank's band centres are spread over
+    static constexpr float bankLowestHz = 80.0f;
+    static constexpr float bankHighestHz = 12000.0f;
+
+    //IDs, names, ranges and defaults of the parameters, the layout and the cached handles are made from this.
+    //defaults are what the filter was hard coded to before it had parameters
+    static constexpr std::array<ParameterTable::Spec, 17> parameterTable{ {
+        ParameterTable::floatParameter(Param::Cutoff, "CUTOFF", "Cutoff Hz", 20.0f, 20000.0f, 150.0f, 0.25f),
+        ParameterTable::floatParameter(Param::Resonance, "RESONANCE", "Resonance", 0.1f, 10.0f, 0.70710678f, 0.5f),
+        ParameterTable::choiceParameter(Param::Type, "TYPE", "Filter Type", typeChoices, 0),
+        //sine LFO on the cutoff, depth is in octaves either side of it
+        ParameterTable::floatParameter(Param::LfoRate, "LFORATE", "LFO Rate Hz", 0.01f, 200.0f, 1.0f, 0.25f),
+        ParameterTable::floatParameter(Param::LfoDepth, "LFODEPTH", "LFO Depth oct", 0.0f, 4.0f, 0.0f),
+        //only used with the Morph type: 0 low pass, 1 band pass, 2 high pass, 3 notch, 4 peak, 5 all pass
+        ParameterTable::floatParameter(Param::Morph, "MORPH", "Morph", 0.0f, ModulatedSVF::maxMorph, 0.0f),
+        ParameterTable::choiceParameter(Param::Slope, "SLOPE", "Slope", slopeChoices, 0),
+        //filter bank: vocodes with the sidechain as the modulator, or resonates on its own without one
+        ParameterTable::choiceParameter(Param::BankBands, "BANKBANDS", "Bank Bands", bankChoices, 0),
+        ParameterTable::floatParameter(Param::BankResonance, "BANKRES", "Bank Resonance", 1.0f, 30.0f, 8.0f, 0.5f),
+        ParameterTable::floatParameter(Param::BankGain, "BANKGAIN", "Bank Gain dB", 0.0f, 36.0f, 12.0f),
+        ParameterTable::floatParameter(Param::BankMix, "BANKMIX", "Bank Mix", 0.0f, 1.0f, 1.0f),
+        //envelope follower on the input moving the cutoff (auto wah), depth is in octaves at full scale
+        ParameterTable::floatParameter(Param::EnvDepth, "ENVDEPTH", "Env Depth oct", -4.0f, 4.0f, 0.0f),
+        ParameterTable::floatParameter(Param::EnvAttack, "ENVATTACK", "Env Attack ms", 0.1f, 100.0f, 5.0f, 0.5f),
+        ParameterTable::floatParameter(Param::EnvRelease, "ENVRELEASE", "Env Release ms", 5.0f, 1000.0f, 100.0f, 0.5f),
+        ParameterTable::choiceParameter(Param::EnvDetector, "ENVDETECTOR", "Env Detector", detectorChoices, 0),
+        //delays the audio (and reports it as latency) so the filter opens before a transient gets there. at 0
+        //there's no delay and no latency. not automatable, the latency only changes on the message thread
+        ParameterTable::notAutomatable(ParameterTable::floatParameter(Param::EnvLookahead, "ENVLOOKAHEAD", "Env Lookahead ms", 0.0f, maxLookaheadMs, 0.0f)),
+        //filter wide layouts' channels on worker threads as well as the audio thread
+        ParameterTable::boolParameter(Param::Parallel, "PARALLEL", "Parallel Channels", false),
+    } };
+
+    static_assert(ParameterTable::isValid(parameterTable), "parameterTable is out of order, has a repeated ID or a default outside its range");
+
+    //parameter values, looked up once here instead of by ID in processBlock
+    ParameterTable::Handles<Param, parameterTable.size()> paramValues{ apvts, parameterTable };
+
     //override reset method for filter
     void reset() override;
     //smethod to set filter type
     void setType();
+    static void setType(ModulatedSVF& filterToSet, FilterType type, float morph) noexcept;
+    //run slice through the bank and mix it back in, modulated by sidechain if that has any channels
+    void processBank(juce::dsp::AudioBlock<float>& slice, const juce::dsp::AudioBlock<float>& sidechain);
+
+    //fill cutoffs with the cutoff for each sample of slice, LFO and envelope included. the envelope
+    //follower reads slice as it goes. returns false (and leaves cutoffs alone) if it's the same for all of them
+    bool updateCutoffs(const juce::dsp::AudioBlock<float>& slice);
+    //delay slice in place by latencySamples (more than 0), and return what the envelope follower
+    //reads: the input as it was before the delay
+    juce::dsp::AudioBlock<float> delayForLookahead(juce::dsp::AudioBlock<float>& slice);
 
-    juce::dsp::StateVariableTPTFilter<float> filter;
+    //the lookahead at sampleRate, reported to the host as latency. message thread only
+    void updateLatency(double sampleRate);
+    //the lookahead moved, report the new latency from the message thread
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    //filter slice with the per sample cutoffs if modulated, otherwise the smoothed cutoff. each
+    //part's channels go to a worker when the parallel mode is on
+    void processFilter(juce::dsp::AudioBlock<float>& slice, bool modulated);
+
+    //call function with every part of the filter in use
+    template <typename Function>
+    void forEachFilter(Function&& function)
+    {
+        for (int part = 0; part < numFilterParts; ++part)
+            function(filters[(size_t) part]);
+    }
+
+    //layouts with this many channels get split into parts that can run at the same time
+    static constexpr int minParallelChannels = 16;
+    //channels in each part, two groups of SSE lanes so a part still runs two side by side
+    static constexpr int channelsPerPart = 8;
+    //slices shorter than this (cut short by MIDI) aren't worth handing to the workers
+    static constexpr int minParallelSamples = 16;
+
+    //works its coefficients out per sample, so the cutoff can move at audio rate. one part for
+    //up to 15 channels, wider layouts split into parts of channelsPerPart
+    std::array<ModulatedSVF, ChannelWorkers::maxTasks> filters;
+    int numFilterParts{ 1 };
+    //only started for wide layouts
+    ChannelWorkers workers;
     FilterType filterType{ FilterType::LowPass };
 
+    //cutoff glides in octaves (so sweeps sound even), resonance is only read per slice
+    Smoothing::Smoother<Smoothing::Method::Multiplicative> cutoffSmoothed{ 150.0f };
+    //morph position, stepped once a slice
+    Smoothing::Smoother<Smoothing::Method::Linear> morphSmoothed;
+    //LFO position, 0 to 1
+    float lfoPhase{ 0.0f };
+    //envelope follower level, squared for RMS
+    float envelope{ 0.0f };
+
+    //ring buffer for the lookahead delay, room for maxLookaheadMs so changing it never allocates
+    juce::AudioBuffer<float> lookaheadBuffer;
+    //the lookahead the host has been told about, set on the message thread
+    std::atomic<int> reportedLatency{ 0 };
+    //the one the audio is delayed by, catches up with reportedLatency at the start of a block
+    int latencySamples{ 0 };
+    int lookaheadPosition{ 0 };
+    //what the envelope follower reads for a slice
+    juce::AudioBuffer<float> detectorBuffer;
+    //cutoff in Hz for each sample of a slice
+    std::array<float, SubBlockScheduler::defaultGridSize> cutoffs{};
+    //splits processBlock into control rate slices
+    SubBlockScheduler scheduler;
+
+    SVFBank bank;
+    //bank settings its coefficients were worked out for
+    int bankNumBands{ 0 };
+    float bankResonance{ 0.0f };
+    //the bank's output for a slice, so the dry signal is still there to mix with
+    juce::AudioBuffer<float> bankBuffer;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BasicSVFAudioProcessor)
 };
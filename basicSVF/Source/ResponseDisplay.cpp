@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    ResponseDisplay.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "ResponseDisplay.h"
+
+ResponseDisplay::ResponseDisplay(BasicSVFAudioProcessor& processorToDraw)
+    : processor(processorToDraw)
+{
+    backgroundColour = getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId);
+    gridColour = backgroundColour.contrasting(0.15f);
+
+    setOpaque(true);
+    renderThread->addTimeSliceClient(this);
+}
+
+ResponseDisplay::~ResponseDisplay()
+{
+    //waits for a render that's already going, so nothing it uses has gone yet
+    renderThread->removeTimeSliceClient(this);
+    cancelPendingUpdate();
+}
+
+void ResponseDisplay::paint(juce::Graphics& g)
+{
+    if (image.isValid())
+        g.drawImage(image, getLocalBounds().toFloat());
+    else
+        g.fillAll(backgroundColour);
+}
+
+void ResponseDisplay::resized()
+{
+    //draw at the screen's resolution, not the component's size in points
+    auto scale = juce::Component::getApproximateScaleFactorForComponent(this);
+
+    imageWidth = juce::roundToInt((float) getWidth() * scale);
+    imageHeight = juce::roundToInt((float) getHeight() * scale);
+}
+
+int ResponseDisplay::useTimeSlice()
+{
+    auto settings = processor.getResponseSettings();
+    int width = imageWidth, height = imageHeight;
+
+    if (width <= 0 || height <= 0
+     || (settings == drawnSettings && width == drawnWidth && height == drawnHeight))
+        return pollMs;
+
+    auto newImage = render(settings, width, height);
+    drawnSettings = settings;
+    drawnWidth = width;
+    drawnHeight = height;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(readyLock);
+        readyImage = std::move(newImage);
+    }
+
+    triggerAsyncUpdate();
+    return pollMs;
+}
+
+void ResponseDisplay::handleAsyncUpdate()
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(readyLock);
+
+        if (! readyImage.isValid())
+            return;
+
+        image = std::move(readyImage);
+        readyImage = {};
+    }
+
+    repaint();
+}
+
+juce::Image ResponseDisplay::render(const BasicSVFAudioProcessor::ResponseSettings& settings, int width, int height)
+{
+    BasicSVFAudioProcessor::setUpFilter(responseFilter, settings);
+
+    auto w = (float) width, h = (float) height;
+    auto xForHz = [&] (double hz) { return w * (float) (std::log(hz / lowestHz) / std::log(highestHz / lowestHz)); };
+    auto yForDecibels = [&] (float dB) { return h * (maxDecibels - dB) / (maxDecibels - minDecibels); };
+    auto yForPhase = [&] (double phase) { return h * (float) (0.5 - 0.5 * phase / juce::MathConstants<double>::pi); };
+
+    //one point per pixel. the phase gets broken where it wraps from -pi to pi instead of
+    //drawing a line straight across
+    juce::Path magnitude, phase;
+    auto lastPhase = 0.0;
+
+    for (int x = 0; x < width; ++x)
+    {
+        auto hz = lowestHz * std::pow(highestHz / lowestHz, (double) x / (double) juce::jmax(1, width - 1));
+        auto response = responseFilter.getResponse(hz, (double) settings.cutoff, settings.sampleRate);
+
+        auto decibels = juce::Decibels::gainToDecibels((float) std::abs(response), minDecibels - 1.0f);
+        auto point = juce::Point<float>((float) x, yForDecibels(decibels));
+        auto angle = std::arg(response);
+        auto phasePoint = juce::Point<float>((float) x, yForPhase(angle));
+
+        if (x == 0)
+            magnitude.startNewSubPath(point);
+        else
+            magnitude.lineTo(point);
+
+        if (x == 0 || std::abs(angle - lastPhase) > juce::MathConstants<double>::pi)
+            phase.startNewSubPath(phasePoint);
+        else
+            phase.lineTo(phasePoint);
+
+        lastPhase = angle;
+    }
+
+    //software image, so it can be drawn into off the message thread
+    juce::Image newImage(juce::Image::RGB, width, height, true, juce::SoftwareImageType());
+    {
+        juce::Graphics g(newImage);
+        g.fillAll(backgroundColour);
+
+        //decades across, 12 dB steps down with 0 dB brighter
+        g.setColour(gridColour);
+
+        for (auto hz : { 100.0, 1000.0, 10000.0 })
+            g.drawVerticalLine(juce::roundToInt(xForHz(hz)), 0.0f, h);
+
+        for (auto dB = maxDecibels - 6.0f; dB > minDecibels; dB -= 12.0f)
+            g.drawHorizontalLine(juce::roundToInt(yForDecibels(dB)), 0.0f, w);
+
+        g.setColour(gridColour.brighter(0.5f));
+        g.drawHorizontalLine(juce::roundToInt(yForDecibels(0.0f)), 0.0f, w);
+
+        auto lineThickness = juce::jmax(1.0f, h / 150.0f);
+        g.setColour(juce::Colours::skyblue.withAlpha(0.6f));
+        g.strokePath(phase, juce::PathStrokeType(lineThickness * 0.75f));
+        g.setColour(juce::Colours::orange);
+        g.strokePath(magnitude, juce::PathStrokeType(lineThickness));
+    }
+
+    return newImage;
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    ResponseDisplay.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Magnitude and phase plot of the filter, drawn on a background thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    A background thread polls the processor's response settings every
+    pollMs. Only when they (or the component's size) have changed does it
+    work out the response of a ModulatedSVF set up the same way, one point
+    per pixel across a log frequency axis, turn it into magnitude and phase
+    paths and draw them into an image. The message thread then just swaps
+    that image in and paint() blits it, so nothing gets worked out when the
+    host repaints and nothing at all happens while the parameters are still.
+
+    Every display shares the one thread through a SharedResourcePointer,
+    so opening lots of editors doesn't start lots of threads. None of it
+    touches the audio thread: the settings are the parameters' atomics.
+*/
+class ResponseDisplay  : public juce::Component,
+                         private juce::TimeSliceClient,
+                         private juce::AsyncUpdater
+{
+public:
+    explicit ResponseDisplay(BasicSVFAudioProcessor& processorToDraw);
+    ~ResponseDisplay() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    //plotted range, frequency on a log scale
+    static constexpr double lowestHz = 20.0;
+    static constexpr double highestHz = 20000.0;
+    static constexpr float minDecibels = -60.0f;
+    static constexpr float maxDecibels = 30.0f;
+    //how often the settings get checked for changes
+    static constexpr int pollMs = 30;
+
+    //the thread every display renders on
+    struct RenderThread  : public juce::TimeSliceThread
+    {
+        RenderThread() : juce::TimeSliceThread("SVF Response Display") { startThread(); }
+        ~RenderThread() override { stopThread(1000); }
+    };
+
+    //background thread: draw a new image if anything changed since the last one
+    int useTimeSlice() override;
+    //message thread: pick up the new image and repaint with it
+    void handleAsyncUpdate() override;
+
+    //background thread: the plot for settings, width by height pixels
+    juce::Image render(const BasicSVFAudioProcessor::ResponseSettings& settings, int width, int height);
+
+    BasicSVFAudioProcessor& processor;
+    juce::SharedResourcePointer<RenderThread> renderThread;
+
+    //colours from the look and feel, found on the message thread since it isn't thread safe
+    juce::Colour backgroundColour, gridColour;
+
+    //size in physical pixels, set on the message thread and read on the background one
+    std::atomic<int> imageWidth{ 0 }, imageHeight{ 0 };
+
+    //only used on the background thread: a filter to ask for the response, and what was last drawn
+    ModulatedSVF responseFilter;
+    BasicSVFAudioProcessor::ResponseSettings drawnSettings{};
+    int drawnWidth{ 0 }, drawnHeight{ 0 };
+
+    //a finished image waiting for the message thread
+    juce::SpinLock readyLock;
+    juce::Image readyImage;
+
+    //what paint() draws
+    juce::Image image;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseDisplay)
+};
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    SVFBank.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "SVFBank.h"
+
+void SVFBank::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    numChannels = (int) spec.numChannels;
+
+    for (auto* states : { &z1, &z2, &carrierZ1, &carrierZ2, &envelopes })
+        states->resize((size_t) (numChannels * maxGroups));
+
+    reset();
+}
+
+void SVFBank::reset()
+{
+    for (auto* states : { &z1, &z2, &carrierZ1, &carrierZ2, &envelopes })
+        std::fill(states->begin(), states->end(), Vec::expand(0.0f));
+}
+
+void SVFBank::setBands(int newNumBands, float lowestHz, float highestHz, float resonance)
+{
+    //whole registers of bands, so every lane that's used is a real band
+    numBands = juce::jlimit(minBands, maxBands, (newNumBands + lanes - 1) / lanes * lanes);
+    numGroups = numBands / lanes;
+
+    auto R2 = 1.0f / juce::jmax(0.01f, resonance);
+    outputGain = R2 * R2;
+
+    auto maxCutoff = 0.49f * (float) sampleRate;
+    highestHz = juce::jlimit(1.0f, maxCutoff, highestHz);
+    lowestHz = juce::jlimit(1.0f, highestHz, lowestHz);
+    auto octaves = std::log2(highestHz / lowestHz);
+
+    for (int group = 0; group < maxGroups; ++group)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            auto band = group * lanes + lane;
+            auto bandA1 = 0.0f, bandA2 = 0.0f, bandA3 = 0.0f;
+
+            if (band < numBands)
+            {
+                auto centre = lowestHz * std::exp2(octaves * (float) band / (float) juce::jmax(1, numBands - 1));
+                auto g = std::tan(juce::MathConstants<float>::pi * centre / (float) sampleRate);
+
+                bandA1 = 1.0f / (1.0f + g * (R2 + g));
+                bandA2 = g * bandA1;
+                bandA3 = g * bandA2;
+            }
+
+            a1[(size_t) group].set((size_t) lane, bandA1);
+            a2[(size_t) group].set((size_t) lane, bandA2);
+            a3[(size_t) group].set((size_t) lane, bandA3);
+        }
+    }
+}
+
+void SVFBank::setEnvelope(float attackMs, float releaseMs)
+{
+    //fraction of the way to the level the envelope moves each sample
+    auto coefficient = [this] (float ms)
+    {
+        return 1.0f - std::exp(-1.0f / (juce::jmax(0.01f, ms) * 0.001f * (float) sampleRate));
+    };
+
+    attack = Vec::expand(coefficient(attackMs));
+    release = Vec::expand(coefficient(releaseMs));
+}
+
+void SVFBank::process(juce::dsp::AudioBlock<float>& block) noexcept
+{
+    auto channels = juce::jmin((int) block.getNumChannels(), numChannels);
+
+    for (int channel = 0; channel < channels; ++channel)
+    {
+        auto* samples = block.getChannelPointer((size_t) channel);
+        processChannel<false>(samples, samples, channel, (int) block.getNumSamples());
+    }
+}
+
+void SVFBank::process(const juce::dsp::AudioBlock<float>& modulator, juce::dsp::AudioBlock<float>& carrier) noexcept
+{
+    auto channels = juce::jmin((int) carrier.getNumChannels(), numChannels);
+    auto numSamples = juce::jmin((int) carrier.getNumSamples(), (int) modulator.getNumSamples());
+
+    if (modulator.getNumChannels() == 0)
+        return;
+
+    for (int channel = 0; channel < channels; ++channel)
+    {
+        auto modulatorChannel = juce::jmin(channel, (int) modulator.getNumChannels() - 1);
+
+        processChannel<true>(modulator.getChannelPointer((size_t) modulatorChannel),
+                             carrier.getChannelPointer((size_t) channel), channel, numSamples);
+    }
+}
+
+template <bool vocoding>
+void SVFBank::processChannel(const float* modulator, float* carrier, int channel, int numSamples) noexcept
+{
+    auto offset = (size_t) (channel * maxGroups);
+    auto* bandZ1 = z1.data() + offset;
+    auto* bandZ2 = z2.data() + offset;
+    auto* bandCarrierZ1 = carrierZ1.data() + offset;
+    auto* bandCarrierZ2 = carrierZ2.data() + offset;
+    auto* bandEnvelopes = envelopes.data() + offset;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto modulatorSample = Vec::expand(modulator[i]);
+        auto sum = Vec::expand(0.0f);
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            auto band = tick(bandZ1[group], bandZ2[group], modulatorSample, group);
+            follow(bandEnvelopes[group], band);
+
+            if constexpr (vocoding)
+                band = tick(bandCarrierZ1[group], bandCarrierZ2[group], Vec::expand(carrier[i]), group);
+
+            sum += band * bandEnvelopes[group];
+        }
+
+        carrier[i] = outputGain * sum.sum();
+    }
+}
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    SVFBank.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Bank of 16 to 64 bandpass state variable filters with an envelope
+    follower on every band, for vocoding and resonator effects.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    The bands go across SIMDRegister lanes instead of the channels: every
+    coefficient, integrator state and envelope is an array with one entry
+    per band, held as registers of lanes bands each. A sample of one channel
+    is broadcast to every lane and each register updates lanes bands at
+    once, so a 32 band bank is 8 register wide filters (4 with AVX) per
+    sample, and the registers don't depend on each other so they overlap.
+
+    The filters are the same TPT structure as ModulatedSVF, taking the
+    bandpass output scaled by R2 so every band peaks at unity. The envelope
+    followers are one pole with separate attack and release, picked without
+    a branch: the rise is max(level - envelope, 0) and the fall is the min.
+
+    process(modulator, carrier) is a vocoder: each band of carrier is scaled
+    by the envelope of the same band of modulator. process(block) uses the
+    block as both, one pass of the filters, which boosts whichever bands are
+    loudest and makes them ring at high resonance.
+*/
+class SVFBank
+{
+public:
+    static constexpr int minBands = 16;
+    static constexpr int maxBands = 64;
+
+    SVFBank() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    //numBands bands with centres spread evenly in octaves from lowestHz to highestHz, all
+    //with the same resonance. works out coefficients, so not every sample
+    void setBands(int newNumBands, float lowestHz, float highestHz, float resonance);
+    void setEnvelope(float attackMs, float releaseMs);
+
+    int getNumBands() const noexcept { return numBands; }
+
+    //each band of block scaled by its own envelope and summed back into block
+    void process(juce::dsp::AudioBlock<float>& block) noexcept;
+    //each band of carrier scaled by the envelope of modulator's band and summed back into carrier.
+    //channels of carrier past modulator's last one use its last channel
+    void process(const juce::dsp::AudioBlock<float>& modulator, juce::dsp::AudioBlock<float>& carrier) noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = (int) Vec::size();
+    static constexpr int maxGroups = maxBands / lanes;
+
+    //one channel through the bank, modulator is the same pointer as carrier without a separate modulator
+    template <bool vocoding>
+    void processChannel(const float* modulator, float* carrier, int channel, int numSamples) noexcept;
+
+    //a group of bands through the filter, returns their bandpass outputs
+    Vec tick(Vec& z1, Vec& z2, Vec input, int group) const noexcept
+    {
+        auto v3 = input - z2;
+        auto v1 = z1 * a1[(size_t) group] + v3 * a2[(size_t) group];
+        auto v2 = z2 + z1 * a2[(size_t) group] + v3 * a3[(size_t) group];
+        z1 = v1 + v1 - z1;
+        z2 = v2 + v2 - z2;
+
+        return v1;
+    }
+
+    //envelope towards the level of band
+    void follow(Vec& envelope, Vec band) const noexcept
+    {
+        auto zero = Vec::expand(0.0f);
+        auto difference = Vec::max(band, zero - band) - envelope;
+        envelope += Vec::max(difference, zero) * attack + Vec::min(difference, zero) * release;
+    }
+
+    double sampleRate{ 44100.0 };
+    int numChannels{ 0 };
+    int numBands{ minBands };
+    int numGroups{ minBands / lanes };
+
+    //coefficients for each band, like ModulatedSVF's. unused lanes are 0 and stay silent
+    std::array<Vec, maxGroups> a1{}, a2{}, a3{};
+    //R2 squared, once for the band and once for its envelope
+    float outputGain{ 1.0f };
+
+    //one pole coefficients for a rising and falling envelope
+    Vec attack{}, release{};
+
+    //per channel per group of bands, [channel * maxGroups + group]. the carrier's filters
+    //are only used when there's a separate modulator
+    std::vector<Vec> z1, z2, carrierZ1, carrierZ2, envelopes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SVFBank)
+};
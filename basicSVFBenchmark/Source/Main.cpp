@@ -0,0 +1,358 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Timings for basicSVF's filters, against juce::dsp::StateVariableTPTFilter
+    where there's something to compare with. Run it with the names of the
+    benchmarks to run, or nothing for all of them, from a Release build.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../shared/Benchmark.h"
+#include "../../basicSVF/Source/PluginProcessor.h"
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+//the processor hands the filter control rate slices this long
+constexpr int sliceSize = 32;
+//a second of audio, long enough that the LFO goes through a whole cycle
+constexpr int numSamples = 48000;
+
+//cutoff for every sample of a second: 1 kHz, swept 3 octaves either way by a 5 Hz LFO
+std::vector<float> makeCutoffSweep()
+{
+    std::vector<float> cutoffs((size_t) numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+        cutoffs[(size_t) i] = 1000.0f * std::exp2(3.0f * std::sin(juce::MathConstants<float>::twoPi * 5.0f * (float) i / (float) sampleRate));
+
+    return cutoffs;
+}
+
+//==============================================================================
+//stereo with the cutoff moving every sample, and with it fixed. StateVariableTPTFilter has to be given each
+//new cutoff with setCutoffFrequency(), which works out its coefficients with std::tan
+void benchmarkModulation()
+{
+    auto cutoffs = makeCutoffSweep();
+    juce::AudioBuffer<float> buffer(2, numSamples);
+    Benchmark::fillWithNoise(buffer);
+    juce::dsp::AudioBlock<float> block(buffer);
+    juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32) sliceSize, 2 };
+
+    ModulatedSVF modulated;
+    modulated.prepare(spec);
+
+    juce::dsp::StateVariableTPTFilter<float> library;
+    library.prepare(spec);
+
+    auto timeModulated = [&] (bool moving)
+    {
+        return Benchmark::nsPerSample(numSamples, [&]
+        {
+            for (int start = 0; start < numSamples; start += sliceSize)
+            {
+                auto slice = block.getSubBlock((size_t) start, (size_t) sliceSize);
+
+                if (moving)
+                    modulated.process(slice, cutoffs.data() + start);
+                else
+                    modulated.process(slice, 1000.0f);
+            }
+        });
+    };
+
+    auto timeLibrary = [&] (bool moving)
+    {
+        library.setCutoffFrequency(1000.0f);
+
+        return Benchmark::nsPerSample(numSamples, [&]
+        {
+            auto* left = buffer.getWritePointer(0);
+            auto* right = buffer.getWritePointer(1);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                if (moving)
+                    library.setCutoffFrequency(cutoffs[(size_t) i]);
+
+                left[i] = library.processSample(0, left[i]);
+                right[i] = library.processSample(1, right[i]);
+            }
+        });
+    };
+
+    std::printf("per sample cutoff, stereo, ns per sample frame\n");
+    std::printf("%10s %16s %24s\n", "cutoff", "ModulatedSVF", "StateVariableTPTFilter");
+    std::printf("%10s %16.2f %24.2f\n", "moving", timeModulated(true), timeLibrary(true));
+    std::printf("%10s %16.2f %24.2f\n", "fixed", timeModulated(false), timeLibrary(false));
+    Benchmark::keep(buffer.getReadPointer(0), numSamples);
+}
+
+//==============================================================================
+//throughput per channel as the layout gets wider. ModulatedSVF runs the channels side by side in SIMDRegister
+//lanes, StateVariableTPTFilter's process() goes through them one at a time
+void benchmarkChannels()
+{
+    auto cutoffs = makeCutoffSweep();
+
+    std::printf("SVF throughput, ns per channel per sample\n");
+    std::printf("%9s %18s %18s %18s %18s\n", "channels", "modulated SIMD", "modulated library", "fixed SIMD", "fixed library");
+
+    for (int numChannels : { 2, 8, 16 })
+    {
+        juce::AudioBuffer<float> buffer(numChannels, numSamples);
+        Benchmark::fillWithNoise(buffer);
+        juce::dsp::AudioBlock<float> block(buffer);
+        juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32) sliceSize, (juce::uint32) numChannels };
+
+        ModulatedSVF modulated;
+        modulated.prepare(spec);
+
+        juce::dsp::StateVariableTPTFilter<float> library;
+        library.prepare(spec);
+        library.setCutoffFrequency(1000.0f);
+
+        auto time = [&] (auto&& processSlice)
+        {
+            auto ns = Benchmark::nsPerSample(numSamples * numChannels, [&]
+            {
+                for (int start = 0; start < numSamples; start += sliceSize)
+                {
+                    auto slice = block.getSubBlock((size_t) start, (size_t) sliceSize);
+                    processSlice(slice, start);
+                }
+            });
+
+            Benchmark::keep(buffer.getReadPointer(0), numSamples);
+            return ns;
+        };
+
+        auto modulatedSimd = time([&] (juce::dsp::AudioBlock<float>& slice, int start) { modulated.process(slice, cutoffs.data() + start); });
+        auto fixedSimd = time([&] (juce::dsp::AudioBlock<float>& slice, int) { modulated.process(slice, 1000.0f); });
+
+        //the library's only way to move the cutoff inside a slice is a sample at a time
+        auto modulatedLibrary = time([&] (juce::dsp::AudioBlock<float>& slice, int start)
+        {
+            for (size_t i = 0; i < slice.getNumSamples(); ++i)
+            {
+                library.setCutoffFrequency(cutoffs[(size_t) start + i]);
+
+                for (size_t channel = 0; channel < slice.getNumChannels(); ++channel)
+                {
+                    auto* samples = slice.getChannelPointer(channel);
+                    samples[i] = library.processSample((int) channel, samples[i]);
+                }
+            }
+        });
+
+        library.setCutoffFrequency(1000.0f);
+        auto fixedLibrary = time([&] (juce::dsp::AudioBlock<float>& slice, int)
+        {
+            juce::dsp::ProcessContextReplacing<float> context(slice);
+            library.process(context);
+        });
+
+        std::printf("%9d %18.2f %18.2f %18.2f %18.2f\n", numChannels, modulatedSimd, modulatedLibrary, fixedSimd, fixedLibrary);
+    }
+}
+
+//==============================================================================
+//stereo throughput with the filter handed whole blocks of each size instead of slices, before (the library
+//filter a sample at a time) and after (ModulatedSVF). stereo is under minChannelsForLanes, so this is
+//ModulatedSVF's scalar pair path, both channels in the same loop with no lanes
+void benchmarkBlocks()
+{
+    auto cutoffs = makeCutoffSweep();
+    juce::AudioBuffer<float> buffer(2, numSamples);
+    Benchmark::fillWithNoise(buffer);
+    juce::dsp::AudioBlock<float> block(buffer);
+
+    std::printf("SVF by block size, stereo, ns per sample frame\n");
+    std::printf("%8s %18s %18s %18s %18s\n", "block", "modulated pairs", "modulated library", "fixed pairs", "fixed library");
+
+    for (int blockSize = 32; blockSize <= 4096; blockSize *= 2)
+    {
+        juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32) blockSize, 2 };
+
+        ModulatedSVF modulated;
+        modulated.prepare(spec);
+
+        juce::dsp::StateVariableTPTFilter<float> library;
+        library.prepare(spec);
+        library.setCutoffFrequency(1000.0f);
+
+        auto time = [&] (auto&& processBlock)
+        {
+            auto ns = Benchmark::nsPerSample(numSamples, [&]
+            {
+                for (int start = 0; start < numSamples; start += blockSize)
+                {
+                    auto sub = block.getSubBlock((size_t) start, (size_t) juce::jmin(blockSize, numSamples - start));
+                    processBlock(sub, start);
+                }
+            });
+
+            Benchmark::keep(buffer.getReadPointer(0), numSamples);
+            return ns;
+        };
+
+        auto modulatedPairs = time([&] (juce::dsp::AudioBlock<float>& sub, int start) { modulated.process(sub, cutoffs.data() + start); });
+        auto fixedPairs = time([&] (juce::dsp::AudioBlock<float>& sub, int) { modulated.process(sub, 1000.0f); });
+
+        auto modulatedLibrary = time([&] (juce::dsp::AudioBlock<float>& sub, int start)
+        {
+            auto* left = sub.getChannelPointer(0);
+            auto* right = sub.getChannelPointer(1);
+
+            for (size_t i = 0; i < sub.getNumSamples(); ++i)
+            {
+                library.setCutoffFrequency(cutoffs[(size_t) start + i]);
+                left[i] = library.processSample(0, left[i]);
+                right[i] = library.processSample(1, right[i]);
+            }
+        });
+
+        library.setCutoffFrequency(1000.0f);
+        auto fixedLibrary = time([&] (juce::dsp::AudioBlock<float>& sub, int)
+        {
+            juce::dsp::ProcessContextReplacing<float> context(sub);
+            library.process(context);
+        });
+
+        std::printf("%8d %18.2f %18.2f %18.2f %18.2f\n", blockSize, modulatedPairs, modulatedLibrary, fixedPairs, fixedLibrary);
+    }
+}
+
+//==============================================================================
+//the filter bank on stereo at each size, as a resonator (one input) and as a vocoder (a separate modulator),
+//and how much of one core that is at 48 kHz
+void benchmarkBank()
+{
+    //the carrier gets the same noise again every run, the bank's output would keep going round otherwise
+    juce::AudioBuffer<float> modulator(2, sliceSize), input(2, numSamples), carrier(2, numSamples);
+    Benchmark::fillWithNoise(modulator, 0.25f, 1);
+    Benchmark::fillWithNoise(input, 0.25f, 2);
+    juce::dsp::AudioBlock<float> modulatorBlock(modulator), carrierBlock(carrier);
+
+    std::printf("SVF bank, stereo, ns per sample frame (%% of a core at 48 kHz)\n");
+    std::printf("%6s %20s %20s\n", "bands", "resonator", "vocoder");
+
+    for (int numBands : { 16, 32, 64 })
+    {
+        SVFBank bank;
+        bank.prepare({ sampleRate, (juce::uint32) sliceSize, 2 });
+        bank.setBands(numBands, 100.0f, 8000.0f, 8.0f);
+        bank.setEnvelope(5.0f, 100.0f);
+
+        auto resonator = Benchmark::nsPerSample(numSamples, [&]
+        {
+            carrier.makeCopyOf(input, true);
+
+            for (int start = 0; start < numSamples; start += sliceSize)
+            {
+                auto slice = carrierBlock.getSubBlock((size_t) start, (size_t) sliceSize);
+                bank.process(slice);
+            }
+        });
+
+        auto vocoder = Benchmark::nsPerSample(numSamples, [&]
+        {
+            carrier.makeCopyOf(input, true);
+
+            for (int start = 0; start < numSamples; start += sliceSize)
+            {
+                auto slice = carrierBlock.getSubBlock((size_t) start, (size_t) sliceSize);
+                bank.process(modulatorBlock, slice);
+            }
+        });
+
+        Benchmark::keep(carrier.getReadPointer(0), numSamples);
+        std::printf("%6d %12.2f (%4.2f%%) %12.2f (%4.2f%%)\n", numBands,
+                    resonator, Benchmark::getCpuPercent(resonator, sampleRate),
+                    vocoder, Benchmark::getCpuPercent(vocoder, sampleRate));
+    }
+}
+
+//==============================================================================
+//how processBlock scales with the layout, from mono up to 16 channels, with the cutoff fixed and with the
+//LFO moving it (so every slice gets a cutoff per sample)
+void benchmarkLayouts()
+{
+    constexpr int blockSize = 512;
+
+    for (auto lfoDepth : { 0.0f, 2.0f })
+    {
+        BasicSVFAudioProcessor processor;
+        Benchmark::setParameter(processor, "CUTOFF", 1000.0f);
+        Benchmark::setParameter(processor, "LFORATE", 5.0f);
+        Benchmark::setParameter(processor, "LFODEPTH", lfoDepth);
+
+        std::printf("processBlock for each layout, %d sample blocks, cutoff %s\n", blockSize, lfoDepth > 0.0f ? "moving" : "fixed");
+        Benchmark::printLayoutScaling(processor, blockSize, sampleRate);
+
+        if (lfoDepth == 0.0f)
+            std::printf("\n");
+    }
+}
+
+//==============================================================================
+//third order ambisonics with the filter's channel groups split across the workers and without, cutoff swept
+//by the LFO, ns per sample frame. there's a handoff for every 32 sample slice
+void benchmarkParallel()
+{
+    BasicSVFAudioProcessor processor;
+    Benchmark::setParameter(processor, "CUTOFF", 1000.0f);
+    Benchmark::setParameter(processor, "LFORATE", 5.0f);
+    Benchmark::setParameter(processor, "LFODEPTH", 2.0f);
+
+    std::printf("PARALLEL, 16 channels, workers: %d, cores: %d, ns per sample frame\n",
+                ChannelWorkers::getAvailableWorkers(), juce::SystemStats::getNumCpus());
+    Benchmark::printParallelSpeedup(processor, juce::AudioChannelSet::ambisonic(3), { 32, 128, 512, 2048 }, sampleRate);
+}
+
+//==============================================================================
+struct Section
+{
+    const char* name;
+    void (*run)();
+};
+
+const Section sections[]{
+    { "modulation", benchmarkModulation },
+    { "channels", benchmarkChannels },
+    { "blocks", benchmarkBlocks },
+    { "bank", benchmarkBank },
+    { "layouts", benchmarkLayouts },
+    { "parallel", benchmarkParallel },
+};
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto& section : sections)
+    {
+        auto requested = argc < 2;
+
+        for (int i = 1; i < argc; ++i)
+            requested = requested || juce::String(argv[i]) == section.name;
+
+        if (requested)
+        {
+            section.run();
+            std::printf("\n");
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,615 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Timings for delayTutorial's processing. Run it with the names of the
+    benchmarks to run, or nothing for all of them. Build it as Release,
+    the numbers from a debug build don't mean anything.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../shared/Benchmark.h"
+#include "../../delayTutorial/Source/PluginProcessor.h"
+
+namespace
+{
+//==============================================================================
+//the delay as processBlock had it before the fused kernel: write, read and feedback are each a
+//pass over the channel through the AudioBuffer helpers, split in two wherever they wrap
+struct ThreePassDelay
+{
+    void prepare(int numChannels, double sampleRate)
+    {
+        delayBuffer.setSize(numChannels, (int) (sampleRate * 2.0));
+        delayBuffer.clear();
+        writePosition = 0;
+    }
+
+    void process(juce::AudioBuffer<float>& buffer, int delaySamples, float feedback)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            fillBuffer(buffer, channel);
+            readFromBuffer(buffer, channel, delaySamples, feedback);
+            fillBuffer(buffer, channel);
+        }
+
+        writePosition = (writePosition + buffer.getNumSamples()) % delayBuffer.getNumSamples();
+    }
+
+    void fillBuffer(juce::AudioBuffer<float>& buffer, int channel)
+    {
+        auto bufferSize = buffer.getNumSamples();
+        auto delayBufferSize = delayBuffer.getNumSamples();
+
+        if (delayBufferSize > bufferSize + writePosition)
+        {
+            delayBuffer.copyFrom(channel, writePosition, buffer.getWritePointer(channel), bufferSize);
+            return;
+        }
+
+        auto numSamplesToEnd = delayBufferSize - writePosition;
+        delayBuffer.copyFrom(channel, writePosition, buffer.getWritePointer(channel), numSamplesToEnd);
+        delayBuffer.copyFrom(channel, 0, buffer.getWritePointer(channel, numSamplesToEnd), bufferSize - numSamplesToEnd);
+    }
+
+    void readFromBuffer(juce::AudioBuffer<float>& buffer, int channel, int delaySamples, float feedback)
+    {
+        auto bufferSize = buffer.getNumSamples();
+        auto delayBufferSize = delayBuffer.getNumSamples();
+        auto readPosition = writePosition - delaySamples;
+
+        if (readPosition < 0)
+            readPosition += delayBufferSize;
+
+        if (readPosition + bufferSize < delayBufferSize)
+        {
+            buffer.addFromWithRamp(channel, 0, delayBuffer.getReadPointer(channel, readPosition), bufferSize, feedback, feedback);
+            return;
+        }
+
+        auto numSamplesToEnd = delayBufferSize - readPosition;
+        buffer.addFromWithRamp(channel, 0, delayBuffer.getReadPointer(channel, readPosition), numSamplesToEnd, feedback, feedback);
+        buffer.addFromWithRamp(channel, numSamplesToEnd, delayBuffer.getReadPointer(channel, 0), bufferSize - numSamplesToEnd, feedback, feedback);
+    }
+
+    juce::AudioBuffer<float> delayBuffer;
+    int writePosition{ 0 };
+};
+
+//the tiles processDelay goes through, on their own: each one reads the delayed signal, scales it by the feedback,
+//adds it to the input and writes that back while it's still in cache. processBlock wraps smoothing, control rate
+//slices and the feedback saturation around this. a moving delay reads every sample through its own index,
+//a fixed one reads straight along the buffer
+struct FusedDelay
+{
+    static constexpr int tileSize = 64;
+
+    explicit FusedDelay(bool delayIsMoving) : moving(delayIsMoving) {}
+
+    void prepare(int numChannels, double sampleRate)
+    {
+        line.setSize(numChannels, (int) (sampleRate * 2.0), tileSize);
+        line.clear();
+        writePosition = 0;
+
+        delayed.assign((size_t) tileSize, 0.0f);
+        delayInts.assign((size_t) tileSize, 0);
+        delayFracs.assign((size_t) tileSize, 0.0f);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer, int delaySamples, float feedback)
+    {
+        auto numSamples = buffer.getNumSamples();
+        std::fill(delayInts.begin(), delayInts.end(), delaySamples);
+
+        for (int tileStart = 0; tileStart < numSamples;)
+        {
+            auto tileLength = juce::jlimit(1, juce::jmin(tileSize, numSamples - tileStart), delaySamples - 1);
+            auto position = writePosition + tileStart;
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                auto* channelData = buffer.getWritePointer(channel, tileStart);
+
+                if (moving)
+                    DelayKernels::readLinear(line.getReader(channel), position, delayInts.data(), delayFracs.data(),
+                                             delayed.data(), tileLength);
+                else
+                    DelayKernels::readLinearConstant(line.getReadPointer(channel, position - delaySamples - 1), 0.0f,
+                                                     delayed.data(), tileLength);
+
+                juce::FloatVectorOperations::addWithMultiply(channelData, delayed.data(), feedback, tileLength);
+                line.write(channel, position, channelData, tileLength);
+            }
+
+            tileStart += tileLength;
+        }
+
+        writePosition = (writePosition + numSamples) & line.getMask();
+    }
+
+    bool moving;
+    MirroredRingBuffer line;
+    int writePosition{ 0 };
+    std::vector<float> delayed;
+    std::vector<int> delayInts;
+    std::vector<float> delayFracs;
+};
+
+//half a second at 48 kHz, and a feedback that keeps the repeats going for a while
+constexpr double sampleRate = 48000.0;
+constexpr int delaySamples = 24000;
+constexpr float feedback = 0.5f;
+
+//a plain single delay: linear interpolation, nothing in the feedback path
+void setSingleDelay(DelayTutorialAudioProcessor& processor)
+{
+    Benchmark::setParameter(processor, "DELAYMS", (float) delaySamples);
+    Benchmark::setParameter(processor, "FEEDBACK", feedback);
+    Benchmark::setParameter(processor, "MODE", 0.0f);
+    Benchmark::setParameter(processor, "INTERP", 0.0f);
+    Benchmark::setParameter(processor, "OSFACTOR", 0.0f);
+}
+
+//==============================================================================
+//stereo: the three passes, the fused tiles that replaced them and the whole processBlock they're in now
+void benchmarkFused()
+{
+    std::printf("fused write/read/feedback, stereo, ns per sample frame\n");
+    std::printf("%8s %12s %14s %14s %14s\n", "block", "three pass", "fused moving", "fused fixed", "processBlock");
+
+    for (int blockSize = 32; blockSize <= 4096; blockSize *= 2)
+    {
+        juce::AudioBuffer<float> input(2, blockSize), buffer(2, blockSize);
+        Benchmark::fillWithNoise(input);
+
+        auto time = [&] (auto& delay)
+        {
+            delay.prepare(2, sampleRate);
+
+            auto ns = Benchmark::nsPerSample(blockSize, [&]
+            {
+                buffer.makeCopyOf(input, true);
+                delay.process(buffer, delaySamples, feedback);
+            });
+
+            Benchmark::keep(buffer.getReadPointer(0), blockSize);
+            return ns;
+        };
+
+        ThreePassDelay threePass;
+        FusedDelay moving(true), fixed(false);
+        auto threePassNs = time(threePass);
+        auto movingNs = time(moving);
+        auto fixedNs = time(fixed);
+
+        DelayTutorialAudioProcessor processor;
+        setSingleDelay(processor);
+        auto processorNs = Benchmark::timeProcessor(processor, juce::AudioChannelSet::stereo(), blockSize, sampleRate);
+
+        std::printf("%8d %12.2f %14.2f %14.2f %14.2f\n", blockSize, threePassNs, movingNs, fixedNs, processorNs);
+    }
+}
+
+//==============================================================================
+//a block written into the delay line and a block read back out, one channel. the old AudioBuffer delay line
+//split both copies in two wherever they crossed its end and wrapped with a modulo, the mirrored one is one copy
+//each way and a mask
+void benchmarkRingBuffer()
+{
+    //2 s at 48 kHz like the old buffer, which isn't a power of two
+    constexpr int lineSize = 96000;
+
+    std::printf("delay line write and read, one channel, ns per sample\n");
+    std::printf("%8s %12s %12s\n", "block", "split copy", "mirrored");
+
+    for (int blockSize = 32; blockSize <= 4096; blockSize *= 2)
+    {
+        juce::AudioBuffer<float> input(1, blockSize), output(1, blockSize);
+        Benchmark::fillWithNoise(input);
+
+        juce::AudioBuffer<float> splitLine(1, lineSize);
+        splitLine.clear();
+        int writePosition = 0;
+
+        auto splitNs = Benchmark::nsPerSample(blockSize, [&]
+        {
+            auto numToEnd = juce::jmin(blockSize, lineSize - writePosition);
+            splitLine.copyFrom(0, writePosition, input, 0, 0, numToEnd);
+            splitLine.copyFrom(0, 0, input, 0, numToEnd, blockSize - numToEnd);
+
+            auto readPosition = writePosition - delaySamples;
+
+            if (readPosition < 0)
+                readPosition += lineSize;
+
+            numToEnd = juce::jmin(blockSize, lineSize - readPosition);
+            output.copyFrom(0, 0, splitLine, 0, readPosition, numToEnd);
+            output.copyFrom(0, numToEnd, splitLine, 0, 0, blockSize - numToEnd);
+
+            writePosition = (writePosition + blockSize) % lineSize;
+        });
+
+        Benchmark::keep(output.getReadPointer(0), blockSize);
+
+        MirroredRingBuffer line;
+        line.setSize(1, lineSize, blockSize);
+        line.clear();
+        int position = 0;
+
+        auto mirroredNs = Benchmark::nsPerSample(blockSize, [&]
+        {
+            line.write(0, position, input.getReadPointer(0), blockSize);
+            output.copyFrom(0, 0, line.getReadPointer(0, position - delaySamples), blockSize);
+
+            position = (position + blockSize) & line.getMask();
+        });
+
+        Benchmark::keep(output.getReadPointer(0), blockSize);
+        std::printf("%8d %12.2f %12.2f%s\n", blockSize, splitNs, mirroredNs, line.isDoubleMapped() ? "" : " (guard copy)");
+    }
+}
+
+//==============================================================================
+//bytes per channel of history, the error a 997 Hz sine comes back out with at two levels, and the cost of
+//writing a tile and reading one back with the linear kernel, for a delay line in one storage format
+template <typename Line>
+void measureFormat(const char* name, Line& line, size_t bytesPerChannel)
+{
+    constexpr int tileSize = 64;
+    constexpr int numSamples = 48000;
+
+    auto getSnr = [&] (float levelDecibels)
+    {
+        std::vector<float> sine((size_t) numSamples);
+        auto amplitude = juce::Decibels::decibelsToGain(levelDecibels);
+
+        for (int i = 0; i < numSamples; ++i)
+            sine[(size_t) i] = amplitude * std::sin(juce::MathConstants<float>::twoPi * 997.0f * (float) i / (float) sampleRate);
+
+        line.clear();
+
+        for (int position = 0; position < numSamples; position += tileSize)
+            line.write(0, position, sine.data() + position, juce::jmin(tileSize, numSamples - position));
+
+        auto reader = line.getReader(0);
+        auto signal = 0.0, error = 0.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            signal += (double) sine[(size_t) i] * sine[(size_t) i];
+            error += juce::square((double) reader[i] - sine[(size_t) i]);
+        }
+
+        return error > 0.0 ? 10.0 * std::log10(signal / error) : std::numeric_limits<double>::infinity();
+    };
+
+    auto loudSnr = getSnr(-6.0f);
+    auto quietSnr = getSnr(-40.0f);
+
+    juce::AudioBuffer<float> input(1, tileSize);
+    Benchmark::fillWithNoise(input);
+    std::vector<float> output((size_t) tileSize), delayFracs((size_t) tileSize, 0.5f);
+    std::vector<int> delayInts((size_t) tileSize, delaySamples);
+    int position = 0;
+
+    auto ns = Benchmark::nsPerSample(tileSize, [&]
+    {
+        line.write(0, position, input.getReadPointer(0), tileSize);
+        DelayKernels::readLinear(line.getReader(0), position, delayInts.data(), delayFracs.data(), output.data(), tileSize);
+        position = (position + tileSize) & line.getMask();
+    });
+
+    Benchmark::keep(output.data(), tileSize);
+    std::printf("%12s %10.1f %12.1f %12.1f %12.2f\n", name, (double) bytesPerChannel / 1024.0, loudSnr, quietSnr, ns);
+}
+
+//every storage format, with room for the longest delay (2 s at 48 kHz)
+void benchmarkFormats()
+{
+    constexpr int lineSize = 96004;
+
+    std::printf("delay storage formats, one channel\n");
+    std::printf("%12s %10s %12s %12s %12s\n", "format", "kB", "SNR -6 dB", "SNR -40 dB", "ns/sample");
+
+    MirroredRingBuffer float32;
+    float32.setSize(1, lineSize, 64);
+    measureFormat("float32", float32, (size_t) float32.getNumSamples() * sizeof(float));
+
+    PackedRingBuffer<DelayCodecs::Float16> float16;
+    float16.setSize(1, lineSize);
+    measureFormat("float16", float16, float16.getMemoryUsage());
+
+    PackedRingBuffer<DelayCodecs::Int16> int16;
+    int16.setSize(1, lineSize);
+    measureFormat("int16", int16, int16.getMemoryUsage());
+
+    PackedRingBuffer<DelayCodecs::BlockFloat> blockFloat;
+    blockFloat.setSize(1, lineSize);
+    measureFormat("block float", blockFloat, blockFloat.getMemoryUsage());
+}
+
+//==============================================================================
+//the feedback path at 18 dB of drive for each oversampling factor: the cost on stereo noise, and how much of
+//a saturated sine comes out aliased, i.e. everything but the harmonics under nyquist, relative to the fundamental
+void benchmarkSaturation()
+{
+    constexpr int tileSize = 64;
+    constexpr int fftOrder = 12;
+    constexpr int fftSize = 1 << fftOrder;
+    //about 7 kHz, a whole number of cycles in the FFT so it needs no window. the 3rd harmonic is
+    //the last one under nyquist, the rest fold back in between
+    constexpr int fundamentalBin = 597;
+
+    std::printf("feedback saturation at 18 dB drive, stereo\n");
+    std::printf("%8s %16s %14s\n", "factor", "ns/sample frame", "aliasing dB");
+
+    struct Setting
+    {
+        const char* name;
+        FeedbackSaturation::Factor factor;
+    };
+
+    for (auto setting : { Setting{ "off", FeedbackSaturation::Factor::Off },
+                          Setting{ "2x", FeedbackSaturation::Factor::Two },
+                          Setting{ "4x", FeedbackSaturation::Factor::Four },
+                          Setting{ "8x", FeedbackSaturation::Factor::Eight } })
+    {
+        FeedbackSaturation saturation;
+        saturation.prepare(sampleRate, 2, tileSize);
+        saturation.setParameters(18.0f, 20000.0f);
+
+        juce::AudioBuffer<float> input(2, tileSize), buffer(2, tileSize);
+        Benchmark::fillWithNoise(input);
+        juce::dsp::AudioBlock<float> block(buffer);
+
+        auto ns = Benchmark::nsPerSample(tileSize, [&]
+        {
+            buffer.makeCopyOf(input, true);
+            saturation.process(block, setting.factor);
+        });
+
+        Benchmark::keep(buffer.getReadPointer(0), tileSize);
+
+        //run the sine through long enough for the filters to settle, then look at the last fftSize samples
+        std::vector<float> spectrum((size_t) fftSize * 2, 0.0f);
+        saturation.reset();
+
+        for (int start = 0; start < 3 * fftSize; start += tileSize)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < tileSize; ++i)
+                    buffer.setSample(channel, i, 0.5f * std::sin(juce::MathConstants<float>::twoPi * fundamentalBin
+                                                                 * (float) ((start + i) % fftSize) / (float) fftSize));
+
+            saturation.process(block, setting.factor);
+
+            if (start >= 2 * fftSize)
+                std::copy_n(buffer.getReadPointer(0), tileSize, spectrum.begin() + (start - 2 * fftSize));
+        }
+
+        juce::dsp::FFT fft(fftOrder);
+        fft.performFrequencyOnlyForwardTransform(spectrum.data());
+
+        auto fundamental = 0.0, aliased = 0.0;
+
+        for (int bin = 1; bin <= fftSize / 2; ++bin)
+        {
+            auto power = juce::square((double) spectrum[(size_t) bin]);
+
+            if (bin == fundamentalBin)
+                fundamental = power;
+            else if (bin % fundamentalBin != 0)
+                aliased += power;
+        }
+
+        std::printf("%8s %16.2f %14.1f\n", setting.name, ns, 10.0 * std::log10(aliased / fundamental));
+    }
+}
+
+//==============================================================================
+//each read kernel on one channel of noise, with the delay sweeping so every sample has a different one
+void benchmarkInterpolation()
+{
+    constexpr int blockSize = 512;
+
+    MirroredRingBuffer line;
+    line.setSize(1, 1 << 17, blockSize);
+
+    juce::AudioBuffer<float> noise(1, blockSize);
+
+    for (int position = 0; position < line.getNumSamples(); position += blockSize)
+    {
+        Benchmark::fillWithNoise(noise, 0.25f, position);
+        line.write(0, position, noise.getReadPointer(0), blockSize);
+    }
+
+    std::vector<float> delayTimes((size_t) blockSize), delayFracs((size_t) blockSize), output((size_t) blockSize);
+    std::vector<int> delayInts((size_t) blockSize);
+
+    for (int i = 0; i < blockSize; ++i)
+        delayTimes[(size_t) i] = 1000.0f + 500.0f * std::sin(juce::MathConstants<float>::twoPi * (float) i / (float) blockSize);
+
+    DelayKernels::splitDelayTimes(delayTimes.data(), delayInts.data(), delayFracs.data(), blockSize);
+
+    std::printf("interpolated delay read, one channel, ns per sample\n");
+
+    struct Mode
+    {
+        const char* name;
+        DelayInterpolation type;
+    };
+
+    for (auto mode : { Mode{ "linear", DelayInterpolation::Linear },
+                       Mode{ "lagrange", DelayInterpolation::Lagrange },
+                       Mode{ "thiran", DelayInterpolation::Thiran } })
+    {
+        int position = 0;
+        auto thiranState = 0.0f;
+
+        auto ns = Benchmark::nsPerSample(blockSize, [&]
+        {
+            DelayKernels::readInterpolated(mode.type, line.getReader(0), position, delayInts.data(), delayFracs.data(),
+                                           output.data(), blockSize, thiranState);
+            position = (position + blockSize) & line.getMask();
+        });
+
+        Benchmark::keep(output.data(), blockSize);
+        std::printf("%20s %8.2f\n", mode.name, ns);
+    }
+
+    //what the processor uses instead of the linear read while the delay isn't moving
+    int position = 0;
+
+    auto ns = Benchmark::nsPerSample(blockSize, [&]
+    {
+        DelayKernels::readLinearConstant(line.getReadPointer(0, position - 1001), 0.5f, output.data(), blockSize);
+        position = (position + blockSize) & line.getMask();
+    });
+
+    Benchmark::keep(output.data(), blockSize);
+    std::printf("%20s %8.2f\n", "linear, fixed delay", ns);
+}
+
+//==============================================================================
+//the grains on their own, stereo, out of 2 s of noise: a density for each count that keeps about that many
+//100 ms grains playing, and the count the pool actually had averaged over every block. per grain-sample is
+//one grain's stereo frame, and the last column is how many grains that is to a core at 48 kHz (the pool
+//stops at GranularEngine::maxGrains whatever that says)
+void benchmarkGranular()
+{
+    constexpr int blockSize = 512;
+    constexpr float grainLength = 4800.0f;
+
+    MirroredRingBuffer line;
+    line.setSize(2, (int) (sampleRate * 2.0), blockSize);
+    auto lineSize = line.getNumSamples();
+
+    juce::AudioBuffer<float> noise(2, lineSize), buffer(2, blockSize);
+    Benchmark::fillWithNoise(noise);
+
+    for (int channel = 0; channel < 2; ++channel)
+        for (int position = 0; position < lineSize; position += blockSize)
+            line.write(channel, position, noise.getReadPointer(channel, position), blockSize);
+
+    std::printf("granular, stereo, %d sample blocks\n", blockSize);
+    std::printf("%8s %8s %16s %18s\n", "grains", "active", "ns/grain-sample", "grains per core");
+
+    for (int numGrains : { 1, 4, 16, 64, 128, 192 })
+    {
+        GranularEngine engine;
+        engine.prepare(sampleRate);
+
+        GranularEngine::Settings settings;
+        settings.density = (float) numGrains * (float) sampleRate / grainLength;
+        settings.lengthSamples = grainLength;
+        settings.delaySamples = (float) delaySamples;
+        settings.spread = 0.5f;
+        settings.pitchSemitones = 0.0f;
+        settings.pitchRandom = 0.1f;
+        settings.panWidth = 1.0f;
+        settings.window = GranularEngine::Window::Hann;
+
+        int writePosition = 0;
+        auto activeSum = 0.0;
+        int calls = 0;
+
+        auto process = [&]
+        {
+            buffer.clear();
+            engine.process(line, writePosition, lineSize, buffer, 2, settings, 1.0f);
+            writePosition = (writePosition + blockSize) & line.getMask();
+        };
+
+        //long enough for the first grains to finish, so the count's settled
+        for (int block = 0; block < 4 * (int) grainLength / blockSize; ++block)
+            process();
+
+        auto ns = Benchmark::nsPerSample(blockSize, [&]
+        {
+            process();
+            activeSum += engine.getNumActiveGrains();
+            ++calls;
+        });
+
+        Benchmark::keep(buffer.getReadPointer(0), blockSize);
+
+        auto active = activeSum / (double) calls;
+        auto nsPerGrainSample = ns / active;
+        std::printf("%8d %8.1f %16.2f %18.0f\n", numGrains, active, nsPerGrainSample, 1.0e9 / (nsPerGrainSample * sampleRate));
+    }
+}
+
+//==============================================================================
+//how processBlock scales with the layout, from mono up to 16 channels, for the plain single delay
+void benchmarkLayouts()
+{
+    constexpr int blockSize = 512;
+
+    DelayTutorialAudioProcessor processor;
+    setSingleDelay(processor);
+
+    std::printf("processBlock for each layout, %d sample blocks\n", blockSize);
+    Benchmark::printLayoutScaling(processor, blockSize, sampleRate);
+}
+
+//==============================================================================
+//third order ambisonics with the channels split across the workers and without, ns per sample frame. the
+//slices are 64 samples however big the block is, so it's one handoff per slice against 4 channels' work each
+void benchmarkParallel()
+{
+    DelayTutorialAudioProcessor processor;
+    setSingleDelay(processor);
+
+    std::printf("PARALLEL, 16 channels, workers: %d, cores: %d, ns per sample frame\n",
+                ChannelWorkers::getAvailableWorkers(), juce::SystemStats::getNumCpus());
+    Benchmark::printParallelSpeedup(processor, juce::AudioChannelSet::ambisonic(3), { 32, 128, 512, 2048 }, sampleRate);
+}
+
+//==============================================================================
+struct Section
+{
+    const char* name;
+    void (*run)();
+};
+
+const Section sections[]{
+    { "interpolation", benchmarkInterpolation },
+    { "ringbuffer", benchmarkRingBuffer },
+    { "formats", benchmarkFormats },
+    { "saturation", benchmarkSaturation },
+    { "fused", benchmarkFused },
+    { "granular", benchmarkGranular },
+    { "layouts", benchmarkLayouts },
+    { "parallel", benchmarkParallel },
+};
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto& section : sections)
+    {
+        auto requested = argc < 2;
+
+        for (int i = 1; i < argc; ++i)
+            requested = requested || juce::String(argv[i]) == section.name;
+
+        if (requested)
+        {
+            section.run();
+            std::printf("\n");
+        }
+    }
+
+    return 0;
+}
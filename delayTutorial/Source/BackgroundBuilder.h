@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    BackgroundBuilder.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Builds (and deletes) objects on a background thread for the audio
+    thread, so it never has to allocate or free anything itself.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    The audio thread posts a Spec with request(), the background thread
+    builds an Object from it, and the audio thread picks it up with
+    takeReady() whenever it's ready. Objects the audio thread is finished
+    with go back through retire() and are deleted on the background thread.
+
+    Everything the audio thread calls is wait-free apart from a short spin
+    lock around the spec and waking the background thread up.
+*/
+template <typename Object, typename Spec>
+class BackgroundBuilder  : private juce::Thread
+{
+public:
+    using BuildFunction = std::function<std::unique_ptr<Object> (const Spec&)>;
+
+    BackgroundBuilder(const juce::String& threadName, BuildFunction functionToUse)
+        : juce::Thread(threadName), build(std::move(functionToUse))
+    {
+    }
+
+    ~BackgroundBuilder() override
+    {
+        stop();
+    }
+
+    void start()
+    {
+        if (! isThreadRunning())
+            startThread();
+    }
+
+    //stop the thread, and delete whatever was built but not taken or retired but not deleted yet
+    void stop()
+    {
+        stopThread(1000);
+
+        {
+            const juce::SpinLock::ScopedLockType lock(specLock);
+            hasRequest = false;
+        }
+
+        delete ready.exchange(nullptr);
+        delete retired.exchange(nullptr);
+    }
+
+    //audio thread: build a new object from spec. a newer request replaces one that hasn't started yet
+    void request(const Spec& spec) noexcept
+    {
+        {
+            const juce::SpinLock::ScopedLockType lock(specLock);
+            pendingSpec = spec;
+            hasRequest = true;
+        }
+
+        notify();
+    }
+
+    //audio thread: the last object built, or nullptr if there isn't a new one. it also holds
+    //on to it until the last retired object has been deleted, so there's never more than one
+    //waiting in retire()
+    std::unique_ptr<Object> takeReady() noexcept
+    {
+        if (retired.load() != nullptr)
+            return {};
+
+        return std::unique_ptr<Object>(ready.exchange(nullptr));
+    }
+
+    //audio thread: hand an object back to be deleted on the background thread
+    void retire(std::unique_ptr<Object> object) noexcept
+    {
+        //takeReady() makes sure the last one has gone
+        jassert(retired.load() == nullptr);
+
+        retired.store(object.release());
+        notify();
+    }
+
+private:
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            delete retired.exchange(nullptr);
+
+            Spec spec{};
+            auto shouldBuild = false;
+
+            {
+                const juce::SpinLock::ScopedLockType lock(specLock);
+                std::swap(shouldBuild, hasRequest);
+                spec = pendingSpec;
+            }
+
+            if (shouldBuild)
+            {
+                auto object = build(spec);
+
+                //replace anything built earlier that the audio thread didn't take in time
+                delete ready.exchange(object.release());
+                continue;
+            }
+
+            wait(-1);
+        }
+    }
+
+    BuildFunction build;
+
+    juce::SpinLock specLock;
+    Spec pendingSpec{};
+    bool hasRequest{ false };
+
+    std::atomic<Object*> ready{ nullptr };
+    std::atomic<Object*> retired{ nullptr };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BackgroundBuilder)
+};
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    DelayInterpolation.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Fractional read kernels for the delay buffer. The kernels read through
+    a reader (see MirroredRingBuffer::Reader) which wraps the index with a
+    mask and turns the stored sample into a float, so the same kernel works
+    for every storage format and the loops have no branches.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//how to read in between two samples of the delay buffer
+enum class DelayInterpolation
+{
+    Linear,
+    Lagrange,
+    Thiran,
+};
+
+namespace DelayKernels
+{
+    //split delay times (in samples) into whole and fractional parts.
+    //this is its own loop so the compiler can vectorize it
+    inline void splitDelayTimes(const float* delayTimes, int* delayInts, float* delayFracs, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto whole = (int) delayTimes[i];
+            delayInts[i] = whole;
+            delayFracs[i] = delayTimes[i] - (float) whole;
+        }
+    }
+
+    //straight line between the two closest samples
+    template <typename Reader>
+    inline void readLinear(const Reader& line, int writePosition,
+                           const int* delayInts, const float* delayFracs, float* dest, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto index = writePosition + i - delayInts[i];
+
+            auto value1 = line[index];
+            auto value2 = line[index - 1];
+
+            dest[i] = value1 + delayFracs[i] * (value2 - value1);
+        }
+    }
+
+    //readLinear for a delay that's the same for every sample. samples points at the oldest of the
+    //numSamples + 1 samples it reads, which have to be contiguous (see MirroredRingBuffer's window)
+    inline void readLinearConstant(const float* samples, float delayFrac, float* dest, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = samples[i + 1] + delayFrac * (samples[i] - samples[i + 1]);
+    }
+
+    //3rd order lagrange, uses 4 samples so the read point is shifted
+    //back one sample to keep it between the middle two
+    template <typename Reader>
+    inline void readLagrange(const Reader& line, int writePosition,
+                             const int* delayInts, const float* delayFracs, float* dest, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto shift = delayInts[i] >= 1 ? 1 : 0;
+            auto delayFrac = delayFracs[i] + (float) shift;
+            auto index = writePosition + i - delayInts[i] + shift;
+
+            auto value1 = line[index];
+            auto value2 = line[index - 1];
+            auto value3 = line[index - 2];
+            auto value4 = line[index - 3];
+
+            auto d1 = delayFrac - 1.0f;
+            auto d2 = delayFrac - 2.0f;
+            auto d3 = delayFrac - 3.0f;
+
+            auto c1 = -d1 * d2 * d3 / 6.0f;
+            auto c2 = d2 * d3 * 0.5f;
+            auto c3 = -d1 * d3 * 0.5f;
+            auto c4 = d1 * d2 / 6.0f;
+
+            dest[i] = value1 * c1 + delayFrac * (value2 * c2 + value3 * c3 + value4 * c4);
+        }
+    }
+
+    //1st order thiran allpass. flat magnitude, but it has a state so it runs
+    //sample by sample. the fraction is kept near 1 so the filter stays well behaved
+    template <typename Reader>
+    inline void readThiran(const Reader& line, int writePosition,
+                           const int* delayInts, const float* delayFracs, float* dest, int numSamples,
+                           float& state)
+    {
+        auto lastOutput = state;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto delayInt = delayInts[i];
+            auto delayFrac = delayFracs[i];
+
+            if (delayFrac < 0.618f && delayInt >= 1)
+            {
+                delayFrac += 1.0f;
+                --delayInt;
+            }
+
+            auto alpha = (1.0f - delayFrac) / (1.0f + delayFrac);
+            auto index = writePosition + i - delayInt;
+
+            auto value1 = line[index];
+            auto value2 = line[index - 1];
+
+            lastOutput = value2 + alpha * (value1 - lastOutput);
+            dest[i] = lastOutput;
+        }
+
+        state = lastOutput;
+    }
+
+    //run whichever read kernel matches the interpolation type
+    template <typename Reader>
+    inline void readInterpolated(DelayInterpolation type, const Reader& line, int writePosition,
+                                 const int* delayInts, const float* delayFracs, float* dest, int numSamples,
+                                 float& thiranState)
+    {
+        switch (type)
+        {
+            case DelayInterpolation::Lagrange:
+                readLagrange(line, writePosition, delayInts, delayFracs, dest, numSamples);
+                break;
+
+            case DelayInterpolation::Thiran:
+                readThiran(line, writePosition, delayInts, delayFracs, dest, numSamples, thiranState);
+                break;
+
+            case DelayInterpolation::Linear:
+            default:
+                readLinear(line, writePosition, delayInts, delayFracs, dest, numSamples);
+                break;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    DelayPrefetcher.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "DelayPrefetcher.h"
+
+DelayPrefetcher::DelayPrefetcher(const MirroredRingBuffer& bufferToPrefetch)
+    : juce::Thread("Delay Prefetch"), buffer(bufferToPrefetch)
+{
+}
+
+DelayPrefetcher::~DelayPrefetcher()
+{
+    stop();
+}
+
+void DelayPrefetcher::start(int lookaheadSamples)
+{
+    stop();
+
+    lookahead = juce::jlimit(1, buffer.getNumSamples(), lookaheadSamples);
+    loadedWindow = packWindow(0, 0);
+    resetStats();
+
+    startThread();
+}
+
+void DelayPrefetcher::stop()
+{
+    stopThread(1000);
+}
+
+void DelayPrefetcher::setPositions(int readPosition, int writePosition) noexcept
+{
+    nextRead = readPosition;
+    nextWrite = writePosition;
+}
+
+bool DelayPrefetcher::checkWindow(int readPosition, int numSamples) noexcept
+{
+    auto window = loadedWindow.load();
+    auto offset = (readPosition - (int) (juce::uint32) (window >> 32)) & buffer.getMask();
+
+    if (offset + numSamples <= (int) (juce::uint32) window)
+        return true;
+
+    ++underruns;
+    return false;
+}
+
+void DelayPrefetcher::resetStats() noexcept
+{
+    underruns = 0;
+    lastPrefetchMs = 0.0;
+}
+
+void DelayPrefetcher::run()
+{
+    while (! threadShouldExit())
+    {
+        auto readPosition = nextRead.load();
+        auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+        touch(readPosition, lookahead);
+        touch(nextWrite.load(), lookahead);
+
+        loadedWindow = packWindow(readPosition, lookahead);
+        lastPrefetchMs = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+        //the read point moves about a block per callback, so a short nap is plenty
+        wait(1);
+    }
+}
+
+void DelayPrefetcher::touch(int position, int numSamples)
+{
+    constexpr int samplesPerPage = 4096 / (int) sizeof(float);
+
+    auto mask = buffer.getMask();
+    auto sum = 0.0f;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* data = buffer.getReadPointer(channel);
+
+        for (int i = 0; i < numSamples; i += samplesPerPage)
+            sum += data[(position + i) & mask];
+
+        sum += data[(position + numSamples - 1) & mask];
+    }
+
+    //keep the reads from being optimised away
+    volatile float sink = sum;
+    juce::ignoreUnused(sink);
+}
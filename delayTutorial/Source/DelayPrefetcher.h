@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    DelayPrefetcher.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Keeps the part of a disk backed delay buffer that's about to be used
+    loaded, so the audio thread doesn't wait on the disk.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MirroredRingBuffer.h"
+
+//==============================================================================
+/**
+    The audio thread posts where it's going to read and write next, and a
+    background thread touches every page from there to lookaheadSamples
+    ahead so they're in memory by the time they're needed.
+
+    The audio thread also checks each block against what was last loaded
+    and counts an underrun whenever it had to read past it.
+*/
+class DelayPrefetcher  : private juce::Thread
+{
+public:
+    explicit DelayPrefetcher(const MirroredRingBuffer& bufferToPrefetch);
+    ~DelayPrefetcher() override;
+
+    //start loading ahead. the buffer must not be resized or released until stop()
+    void start(int lookaheadSamples);
+    void stop();
+
+    //audio thread: where the next block starts reading and writing. wait-free
+    void setPositions(int readPosition, int writePosition) noexcept;
+    //audio thread: returns false (and counts an underrun) if the samples about to
+    //be read weren't loaded in time. wait-free
+    bool checkWindow(int readPosition, int numSamples) noexcept;
+
+    //stats, safe to read from any thread
+    int getNumUnderruns() const noexcept { return underruns.load(); }
+    double getLastPrefetchMs() const noexcept { return lastPrefetchMs.load(); }
+    void resetStats() noexcept;
+
+private:
+    void run() override;
+    //read one sample per page so the OS loads it
+    void touch(int position, int numSamples);
+
+    const MirroredRingBuffer& buffer;
+    int lookahead{ 0 };
+
+    std::atomic<int> nextRead{ 0 };
+    std::atomic<int> nextWrite{ 0 };
+
+    //range of the read side that was loaded on the last pass, start << 32 | length. one atomic
+    //so the audio thread never sees the start of one pass with the length of another
+    std::atomic<juce::uint64> loadedWindow{ 0 };
+
+    static juce::uint64 packWindow(int start, int length) noexcept { return ((juce::uint64) (juce::uint32) start << 32) | (juce::uint32) length; }
+
+    std::atomic<int> underruns{ 0 };
+    std::atomic<double> lastPrefetchMs{ 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayPrefetcher)
+};
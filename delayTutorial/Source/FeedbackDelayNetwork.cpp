@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    FeedbackDelayNetwork.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "FeedbackDelayNetwork.h"
+
+//line lengths at size 1, the others are spread between these
+static constexpr float shortestLineMs = 20.0f;
+static constexpr float longestLineMs = 80.0f;
+
+//smallest prime >= n
+static int nextPrime(int n)
+{
+    n = juce::jmax(2, n);
+
+    for (;; ++n)
+    {
+        auto isPrime = true;
+
+        for (int factor = 2; factor * factor <= n && isPrime; ++factor)
+            isPrime = (n % factor) != 0;
+
+        if (isPrime)
+            return n;
+    }
+}
+
+void FeedbackDelayNetwork::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    //room for the longest line at the biggest size, plus some for rounding up to a prime
+    auto longest = (int) std::ceil(sampleRate * maxSize * longestLineMs * 0.001) + 100;
+    lines.setSize(maxLines, longest + maxTileSize, maxTileSize);
+    writePosition = 0;
+
+    //force the lines to be set up again for the new sample rate
+    settings.fill(-1.0f);
+    reset();
+}
+
+void FeedbackDelayNetwork::release()
+{
+    lines.release();
+}
+
+void FeedbackDelayNetwork::reset()
+{
+    lines.clear();
+    dampingStates.fill(0.0f);
+}
+
+void FeedbackDelayNetwork::setParameters(int newNumLines, Matrix newMatrix, float size, float decaySeconds, float dampingHz)
+{
+    std::array<float, 5> newSettings{ (float) newNumLines, (float) (int) newMatrix, size, decaySeconds, dampingHz };
+
+    if (newSettings == settings || lines.getNumSamples() == 0)
+        return;
+
+    settings = newSettings;
+
+    //the butterfly needs a power of two
+    numLines = juce::nextPowerOfTwo(juce::jlimit(4, maxLines, newNumLines));
+    matrix = newMatrix;
+    size = juce::jlimit(0.25f, maxSize, size);
+    decaySeconds = juce::jmax(0.01f, decaySeconds);
+    tileLength = maxTileSize;
+
+    for (int line = 0; line < numLines; ++line)
+    {
+        //lengths are spread exponentially and moved up to a prime, so no two lines share
+        //a factor and their echoes don't pile up on the same samples
+        auto ms = shortestLineMs * std::pow(longestLineMs / shortestLineMs, (float) line / (float) (numLines - 1));
+        auto length = nextPrime((int) (ms * 0.001f * size * (float) sampleRate));
+        delays[(size_t) line] = juce::jmin(length, lines.getNumSamples() - maxTileSize);
+
+        //gain for one trip round the line, so every line is down 60 dB after decaySeconds
+        decayGains[(size_t) line] = std::pow(10.0f, -3.0f * (float) delays[(size_t) line] / (decaySeconds * (float) sampleRate));
+
+        tileLength = juce::jmin(tileLength, delays[(size_t) line]);
+    }
+
+    auto cutoff = juce::jlimit(20.0f, (float) sampleRate * 0.49f, dampingHz);
+    dampingCoefficient = 1.0f - std::exp(-juce::MathConstants<float>::twoPi * cutoff / (float) sampleRate);
+}
+
+void FeedbackDelayNetwork::process(juce::AudioBuffer<float>& buffer, int numChannels, float wet) noexcept
+{
+    if (lines.getNumSamples() == 0 || numChannels <= 0)
+        return;
+
+    for (int start = 0; start < buffer.getNumSamples();)
+    {
+        auto numSamples = juce::jmin(tileLength, buffer.getNumSamples() - start);
+        processTile(buffer, numChannels, start, numSamples, wet);
+        start += numSamples;
+    }
+}
+
+void FeedbackDelayNetwork::processTile(juce::AudioBuffer<float>& buffer, int numChannels, int start, int numSamples, float wet) noexcept
+{
+    //mono sum of the input goes into every line
+    juce::FloatVectorOperations::copy(input.data(), buffer.getReadPointer(0, start), numSamples);
+
+    for (int channel = 1; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::add(input.data(), buffer.getReadPointer(channel, start), numSamples);
+
+    juce::FloatVectorOperations::multiply(input.data(), 1.0f / (float) numChannels, numSamples);
+
+    //read every line, then damp it and let it decay
+    for (int line = 0; line < numLines; ++line)
+    {
+        auto* samples = tile[(size_t) line].data();
+        auto gain = decayGains[(size_t) line];
+        auto state = dampingStates[(size_t) line];
+
+        juce::FloatVectorOperations::copy(samples, lines.getReadPointer(line, writePosition - delays[(size_t) line]), numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            state += dampingCoefficient * (samples[i] - state);
+            samples[i] = state * gain;
+        }
+
+        dampingStates[(size_t) line] = state;
+    }
+
+    //lines take turns between the output channels. each channel sums numLines / numChannels
+    //uncorrelated lines, so scale them back to about the level of one
+    auto outputGain = wet / std::sqrt((float) numLines / (float) juce::jmin(numChannels, numLines));
+
+    for (int line = 0; line < numLines; ++line)
+        juce::FloatVectorOperations::addWithMultiply(buffer.getWritePointer(line % numChannels, start),
+                                                     tile[(size_t) line].data(), outputGain, numSamples);
+
+    if (matrix == Matrix::Hadamard)
+        mixHadamard(numSamples);
+    else
+        mixHouseholder(numSamples);
+
+    //feed the input in with alternating signs so it doesn't just line up with the first
+    //row of the matrix, then everything goes back into the lines
+    for (int line = 0; line < numLines; ++line)
+    {
+        auto* samples = tile[(size_t) line].data();
+
+        juce::FloatVectorOperations::addWithMultiply(samples, input.data(), line % 2 == 0 ? 1.0f : -1.0f, numSamples);
+        lines.write(line, writePosition, samples, numSamples);
+    }
+
+    writePosition = (writePosition + numSamples) & lines.getMask();
+}
+
+void FeedbackDelayNetwork::mixHadamard(int numSamples) noexcept
+{
+    //fast walsh-hadamard transform: log2(numLines) stages of sum / difference pairs
+    for (int half = 1; half < numLines; half *= 2)
+    {
+        for (int group = 0; group < numLines; group += half * 2)
+        {
+            for (int line = group; line < group + half; ++line)
+            {
+                auto* a = tile[(size_t) line].data();
+                auto* b = tile[(size_t) (line + half)].data();
+
+                juce::FloatVectorOperations::copy(scratch.data(), a, numSamples);
+                juce::FloatVectorOperations::add(a, b, numSamples);
+                juce::FloatVectorOperations::subtract(b, scratch.data(), b, numSamples);
+            }
+        }
+    }
+
+    //scaled so the matrix is orthogonal, which keeps the loop lossless (decay gains do the rest)
+    auto scale = 1.0f / std::sqrt((float) numLines);
+
+    for (int line = 0; line < numLines; ++line)
+        juce::FloatVectorOperations::multiply(tile[(size_t) line].data(), scale, numSamples);
+}
+
+void FeedbackDelayNetwork::mixHouseholder(int numSamples) noexcept
+{
+    //I - 2/N * ones: every line minus 2/N of the sum of all of them
+    juce::FloatVectorOperations::copy(scratch.data(), tile[0].data(), numSamples);
+
+    for (int line = 1; line < numLines; ++line)
+        juce::FloatVectorOperations::add(scratch.data(), tile[(size_t) line].data(), numSamples);
+
+    auto scale = -2.0f / (float) numLines;
+
+    for (int line = 0; line < numLines; ++line)
+        juce::FloatVectorOperations::addWithMultiply(tile[(size_t) line].data(), scratch.data(), scale, numSamples);
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    FeedbackDelayNetwork.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    4, 8 or 16 delay lines feeding back into each other through a mixing
+    matrix, for a reverb that runs inside the delay.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MirroredRingBuffer.h"
+
+//==============================================================================
+/**
+    Every line is a channel of one MirroredRingBuffer, so a tile of any line
+    can be read or written as one contiguous run of samples.
+
+    The network runs a tile at a time (never longer than the shortest line),
+    with the tile of every line held side by side. That way the mixing
+    matrix works on whole tiles: the Hadamard matrix is a fast Walsh-Hadamard
+    butterfly (N log N adds instead of N * N multiplies) and Householder is
+    one sum and one subtract per line, and each step is a vectorized
+    FloatVectorOperations call over the tile.
+
+    Each line has a one pole lowpass (damping) and a gain that sets its
+    decay time, so every line dies away at the same rate whatever its length.
+*/
+class FeedbackDelayNetwork
+{
+public:
+    enum class Matrix
+    {
+        Hadamard,
+        Householder,
+    };
+
+    static constexpr int maxLines = 16;
+    static constexpr int maxTileSize = 64;
+    //size scales every line length, this is the largest it goes
+    static constexpr float maxSize = 2.0f;
+
+    FeedbackDelayNetwork() = default;
+
+    //allocates the delay lines for the longest size at this sample rate
+    void prepare(double sampleRate);
+    void release();
+    //silence every line
+    void reset();
+
+    //numLines is 4, 8 or 16. size scales the line lengths (0.25 to maxSize), decay is the time
+    //in seconds to fall by 60 dB and damping is the lowpass cutoff inside the loop in Hz.
+    //only recalculates when something changed
+    void setParameters(int numLines, Matrix matrix, float size, float decaySeconds, float dampingHz);
+
+    //mix the reverb of the first numChannels channels into them (in place), wet is its level
+    void process(juce::AudioBuffer<float>& buffer, int numChannels, float wet) noexcept;
+
+private:
+    //one tile through the network, starting at sample start of buffer
+    void processTile(juce::AudioBuffer<float>& buffer, int numChannels, int start, int numSamples, float wet) noexcept;
+    void mixHadamard(int numSamples) noexcept;
+    void mixHouseholder(int numSamples) noexcept;
+
+    double sampleRate{ 44100.0 };
+    MirroredRingBuffer lines;
+    int writePosition{ 0 };
+
+    int numLines{ 4 };
+    Matrix matrix{ Matrix::Hadamard };
+    //parameters the lines were last set up with (lines, matrix, size, decay, damping)
+    std::array<float, 5> settings{};
+
+    std::array<int, maxLines> delays{};
+    std::array<float, maxLines> decayGains{};
+    std::array<float, maxLines> dampingStates{};
+    float dampingCoefficient{ 1.0f };
+    //the tile never gets longer than the shortest line
+    int tileLength{ maxTileSize };
+
+    //one tile of every line, side by side, plus room for a butterfly
+    std::array<std::array<float, maxTileSize>, maxLines> tile{};
+    std::array<float, maxTileSize> scratch{};
+    std::array<float, maxTileSize> input{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FeedbackDelayNetwork)
+};
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    FeedbackSaturation.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "FeedbackSaturation.h"
+
+void FeedbackSaturation::prepare(double newSampleRate, int numChannels, int maxBlockSize)
+{
+    sampleRate = newSampleRate;
+
+    //polyphase IIR half band stages: 1 stage for 2x, 2 for 4x, 3 for 8x. integer latency
+    //so the delay can take it off the read position exactly
+    for (size_t stages = 1; stages <= oversamplers.size(); ++stages)
+    {
+        auto& oversampler = oversamplers[stages - 1];
+        oversampler = std::make_unique<juce::dsp::Oversampling<float>>((size_t) numChannels, stages,
+                                                                       juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+                                                                       true, true);
+        oversampler->initProcessing((size_t) maxBlockSize);
+    }
+
+    toneStates.assign((size_t) numChannels, 0.0f);
+    setParameters(0.0f, 20000.0f);
+    reset();
+}
+
+void FeedbackSaturation::reset()
+{
+    for (auto& oversampler : oversamplers)
+        if (oversampler != nullptr)
+            oversampler->reset();
+
+    std::fill(toneStates.begin(), toneStates.end(), 0.0f);
+}
+
+void FeedbackSaturation::setParameters(float driveDecibels, float toneHz) noexcept
+{
+    drive = juce::Decibels::decibelsToGain(driveDecibels);
+    makeup = 1.0f / drive;
+
+    auto cutoff = juce::jlimit(20.0f, (float) sampleRate * 0.49f, toneHz);
+    toneCoefficient = 1.0f - std::exp(-juce::MathConstants<float>::twoPi * cutoff / (float) sampleRate);
+}
+
+int FeedbackSaturation::getLatency(Factor factor) const noexcept
+{
+    if (factor == Factor::Off)
+        return 0;
+
+    auto& oversampler = oversamplers[(size_t) factor - 1];
+    return oversampler != nullptr ? juce::roundToInt(oversampler->getLatencyInSamples()) : 0;
+}
+
+void FeedbackSaturation::process(juce::dsp::AudioBlock<float>& block, Factor factor) noexcept
+{
+    auto numChannels = juce::jmin((int) block.getNumChannels(), (int) toneStates.size());
+    auto numSamples = (int) block.getNumSamples();
+
+    if (factor != currentFactor)
+    {
+        reset();
+        currentFactor = factor;
+    }
+
+    if (factor == Factor::Off || oversamplers[(size_t) factor - 1] == nullptr)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            saturate(block.getChannelPointer((size_t) channel), numSamples);
+    }
+    else
+    {
+        auto& oversampler = *oversamplers[(size_t) factor - 1];
+        auto upsampled = oversampler.processSamplesUp(block);
+
+        for (size_t channel = 0; channel < upsampled.getNumChannels(); ++channel)
+            saturate(upsampled.getChannelPointer(channel), (int) upsampled.getNumSamples());
+
+        oversampler.processSamplesDown(block);
+    }
+
+    //tone filter at the normal rate, nothing up there needs it
+    filterTone(block, numChannels, numSamples);
+}
+
+void FeedbackSaturation::filterTone(juce::dsp::AudioBlock<float>& block, int numChannels, int numSamples) noexcept
+{
+    //state * (1 - coefficient) + coefficient * input, one multiply and add from each sample to the next.
+    //that chain is what a channel waits on, so channels go through four side by side with all four
+    //chains going at once (over twice as fast per channel as one at a time from 12 channels up)
+    auto coefficient = toneCoefficient;
+    auto decay = 1.0f - toneCoefficient;
+    int channel = 0;
+
+    for (; channel + 4 <= numChannels; channel += 4)
+    {
+        auto* a = block.getChannelPointer((size_t) channel);
+        auto* b = block.getChannelPointer((size_t) channel + 1);
+        auto* c = block.getChannelPointer((size_t) channel + 2);
+        auto* d = block.getChannelPointer((size_t) channel + 3);
+        auto* states = toneStates.data() + channel;
+        auto stateA = states[0], stateB = states[1], stateC = states[2], stateD = states[3];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            stateA = stateA * decay + coefficient * a[i];
+            stateB = stateB * decay + coefficient * b[i];
+            stateC = stateC * decay + coefficient * c[i];
+            stateD = stateD * decay + coefficient * d[i];
+            a[i] = stateA;
+            b[i] = stateB;
+            c[i] = stateC;
+            d[i] = stateD;
+        }
+
+        states[0] = stateA;
+        states[1] = stateB;
+        states[2] = stateC;
+        states[3] = stateD;
+    }
+
+    for (; channel < numChannels; ++channel)
+    {
+        auto* samples = block.getChannelPointer((size_t) channel);
+        auto state = toneStates[(size_t) channel];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            state = state * decay + coefficient * samples[i];
+            samples[i] = state;
+        }
+
+        toneStates[(size_t) channel] = state;
+    }
+}
+
+void FeedbackSaturation::saturate(float* samples, int numSamples) const noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+        samples[i] = std::tanh(drive * samples[i]) * makeup;
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    FeedbackSaturation.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Tape style saturation and tone filter for the signal going back round
+    the delay, oversampled so the saturation doesn't alias.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Only the feedback signal goes through here (never the dry path), so the
+    oversampling costs scale with the effect and not with the whole plugin.
+
+    The saturation is tanh(drive * x) / drive: unity gain for quiet signals,
+    and it never adds gain, so the loop stays stable at any drive. After
+    coming back down to the normal rate the signal goes through a one pole
+    lowpass, like the treble loss of a tape or bucket brigade delay.
+*/
+class FeedbackSaturation
+{
+public:
+    //order matches the OSFACTOR parameter
+    enum class Factor
+    {
+        Off,
+        Two,
+        Four,
+        Eight,
+    };
+
+    FeedbackSaturation() = default;
+
+    //allocates the oversamplers, so never on the audio thread
+    void prepare(double sampleRate, int numChannels, int maxBlockSize);
+    void reset();
+
+    void setParameters(float driveDecibels, float toneHz) noexcept;
+
+    //extra delay the oversampler adds to the loop, in samples at the normal rate
+    int getLatency(Factor factor) const noexcept;
+
+    //saturate and filter block in place, one channel per feedback signal
+    void process(juce::dsp::AudioBlock<float>& block, Factor factor) noexcept;
+
+private:
+    void saturate(float* samples, int numSamples) const noexcept;
+    //the one pole lowpass on the first numChannels channels of block
+    void filterTone(juce::dsp::AudioBlock<float>& block, int numChannels, int numSamples) noexcept;
+
+    double sampleRate{ 44100.0 };
+
+    //one per factor (2x, 4x, 8x), all built up front so switching is free
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, 3> oversamplers;
+
+    //the oversamplers get cleared when the factor changes, so old samples don't come back out
+    Factor currentFactor{ Factor::Off };
+
+    float drive{ 1.0f };
+    float makeup{ 1.0f };
+    float toneCoefficient{ 1.0f };
+    //one per channel, sized by prepare()
+    std::vector<float> toneStates;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FeedbackSaturation)
+};
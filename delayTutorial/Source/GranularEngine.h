@@ -0,0 +1,249 @@
+/*
+  ==============================================================================
+
+    GranularEngine.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Grains played out of the delay history, each with its own position,
+    pitch, window and pan.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    All grains live in a fixed pool and every window shape is a table made
+    up front, so spawning a grain is just taking an index off the free list
+    and nothing allocates on the audio thread.
+
+    Grains are processed one at a time over the whole block (rather than
+    every grain for each sample), so a grain's state stays in registers and
+    the delay history it reads from is walked in order.
+
+    Grains get panned across mono and stereo. With more channels than that
+    (surround or ambisonics) every channel plays them as if panned centre.
+*/
+class GranularEngine
+{
+public:
+    enum class Window
+    {
+        Hann,
+        Gaussian,
+        Trapezoid,
+    };
+
+    static constexpr int maxGrains = 256;
+    static constexpr int tableSize = 512;
+
+    struct Settings
+    {
+        //grains started per second
+        float density;
+        float lengthSamples;
+        //how far back grains read from, and how much that's randomised (0 to 1 of it)
+        float delaySamples;
+        float spread;
+        float pitchSemitones;
+        //random pitch either side of pitchSemitones
+        float pitchRandom;
+        //random pan either side of the centre (0 to 1)
+        float panWidth;
+        Window window;
+    };
+
+    GranularEngine()
+    {
+        //tables go one past the end so the interpolated lookup never needs to wrap
+        for (int i = 0; i <= tableSize; ++i)
+        {
+            auto x = (float) i / (float) tableSize;
+
+            windows[(size_t) Window::Hann][(size_t) i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * x);
+            windows[(size_t) Window::Gaussian][(size_t) i] = std::exp(-0.5f * juce::square((x - 0.5f) / 0.15f));
+            windows[(size_t) Window::Trapezoid][(size_t) i] = juce::jmin(1.0f, 5.0f * x, 5.0f * (1.0f - x));
+        }
+
+        reset();
+    }
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    //stop every grain
+    void reset()
+    {
+        numActive = 0;
+
+        for (int i = 0; i < maxGrains; ++i)
+            freeList[(size_t) i] = i;
+
+        numFree = maxGrains;
+        samplesToNextGrain = 0.0f;
+    }
+
+    int getNumActiveGrains() const noexcept { return numActive; }
+
+    //add the grains for this block of the first numChannels channels of buffer into it.
+    //writePosition is where buffer's first sample has been written in line, lineSize is
+    //how much history line holds
+    template <typename RingBuffer>
+    void process(const RingBuffer& line, int writePosition, int lineSize, juce::AudioBuffer<float>& buffer,
+                 int numChannels, const Settings& settings, float wet) noexcept
+    {
+        auto numSamples = buffer.getNumSamples();
+        numChannels = juce::jmin(numChannels, line.getNumChannels());
+
+        //grains overlap about density * length times, keep the sum around the level of one
+        auto overlap = settings.density * settings.lengthSamples / (float) sampleRate;
+        auto level = wet / std::sqrt(juce::jmax(1.0f, overlap));
+
+        //start the grains due in this block, each at its own sample
+        auto interval = (float) sampleRate / juce::jmax(0.01f, settings.density);
+
+        while (samplesToNextGrain < (float) numSamples)
+        {
+            spawn(settings, (int) samplesToNextGrain, lineSize);
+            //a little jitter so dense clouds don't buzz at the grain rate
+            samplesToNextGrain += interval * (0.75f + 0.5f * random.nextFloat());
+        }
+
+        samplesToNextGrain -= (float) numSamples;
+
+        for (int index = 0; index < numActive;)
+        {
+            auto& grain = grains[(size_t) activeList[(size_t) index]];
+
+            if (renderGrain(grain, line, writePosition, buffer, numChannels, level))
+            {
+                ++index;
+                continue;
+            }
+
+            //finished, give it back to the pool
+            freeList[(size_t) numFree++] = activeList[(size_t) index];
+            activeList[(size_t) index] = activeList[(size_t) --numActive];
+        }
+    }
+
+private:
+    struct Grain
+    {
+        //samples behind the write position, and how much that changes per sample (1 - pitch ratio)
+        float delay;
+        float delayStep;
+        //position in the window (0 to 1)
+        float phase;
+        float phaseStep;
+        //left and right
+        std::array<float, 2> gains;
+        int window;
+        //first sample of the block it plays from, only the block it starts in isn't 0
+        int startOffset;
+    };
+
+    void spawn(const Settings& settings, int offset, int lineSize) noexcept
+    {
+        //pool's empty, skip this one rather than steal a grain that's still playing
+        if (numFree == 0)
+            return;
+
+        auto index = freeList[(size_t) --numFree];
+        auto& grain = grains[(size_t) index];
+
+        auto length = juce::jmax(16.0f, settings.lengthSamples);
+        auto semitones = settings.pitchSemitones + settings.pitchRandom * (2.0f * random.nextFloat() - 1.0f);
+        auto ratio = std::exp2(semitones / 12.0f);
+        auto delay = settings.delaySamples * (1.0f - settings.spread * random.nextFloat());
+
+        //keep the whole grain inside the history: pitched up grains catch up with the
+        //write position, pitched down ones fall further behind
+        auto travel = (ratio - 1.0f) * length;
+        auto minDelay = 2.0f + juce::jmax(0.0f, travel);
+        auto maxDelay = (float) lineSize - 4.0f + juce::jmin(0.0f, travel);
+
+        grain.delay = juce::jmax(minDelay, juce::jmin(maxDelay, delay));
+        grain.delayStep = 1.0f - ratio;
+        grain.phase = 0.0f;
+        grain.phaseStep = 1.0f / length;
+        grain.window = (int) settings.window;
+        grain.startOffset = offset;
+
+        //equal power pan
+        auto pan = settings.panWidth * (2.0f * random.nextFloat() - 1.0f);
+        auto angle = (pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+        grain.gains = { std::cos(angle), std::sin(angle) };
+
+        activeList[(size_t) numActive++] = index;
+    }
+
+    //returns false once the grain has finished
+    template <typename RingBuffer>
+    bool renderGrain(Grain& grain, const RingBuffer& line, int writePosition, juce::AudioBuffer<float>& buffer,
+                     int numChannels, float level) noexcept
+    {
+        auto numSamples = buffer.getNumSamples();
+        auto start = grain.startOffset;
+        auto numToRender = juce::jmin(numSamples - start, (int) std::ceil((1.0f - grain.phase) / grain.phaseStep));
+        auto& table = windows[(size_t) grain.window];
+        grain.startOffset = 0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto reader = line.getReader(channel);
+            auto* output = buffer.getWritePointer(channel);
+            //only stereo gets panned, mono and wider layouts get every grain at the centre gain
+            auto pan = numChannels == 2 ? grain.gains[(size_t) channel] : juce::MathConstants<float>::sqrt2 * 0.5f;
+            auto gain = pan * level;
+            auto delay = grain.delay;
+            auto phase = grain.phase;
+
+            for (int i = start; i < start + numToRender; ++i)
+            {
+                //linear interpolated read, same convention as the delay's (position - delay)
+                auto delayInt = (int) delay;
+                auto frac = delay - (float) delayInt;
+                auto readIndex = writePosition + i - delayInt;
+                auto sample = reader[readIndex] + frac * (reader[readIndex - 1] - reader[readIndex]);
+
+                auto tablePosition = phase * (float) tableSize;
+                auto tableIndex = juce::jmin(tableSize - 1, (int) tablePosition);
+                auto window = table[(size_t) tableIndex] + (tablePosition - (float) tableIndex) * (table[(size_t) tableIndex + 1] - table[(size_t) tableIndex]);
+
+                output[i] += sample * window * gain;
+
+                delay += grain.delayStep;
+                phase += grain.phaseStep;
+            }
+        }
+
+        grain.delay += grain.delayStep * (float) numToRender;
+        grain.phase += grain.phaseStep * (float) numToRender;
+
+        return grain.phase < 1.0f;
+    }
+
+    double sampleRate{ 44100.0 };
+    juce::Random random;
+
+    std::array<std::array<float, tableSize + 1>, 3> windows;
+
+    std::array<Grain, maxGrains> grains{};
+    //indices into grains
+    std::array<int, maxGrains> freeList{};
+    std::array<int, maxGrains> activeList{};
+    int numFree{ 0 };
+    int numActive{ 0 };
+
+    float samplesToNextGrain{ 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GranularEngine)
+};
@@ -0,0 +1,243 @@
+/*
+  ==============================================================================
+
+    MirroredRingBuffer.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "MirroredRingBuffer.h"
+
+#if JUCE_LINUX
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+MirroredRingBuffer::~MirroredRingBuffer()
+{
+    release();
+}
+
+void MirroredRingBuffer::setSize(int newNumChannels, int minNumSamples, int newWindowSize)
+{
+    setChannelSize(newNumChannels, minNumSamples, newWindowSize);
+
+   #if JUCE_LINUX
+    if (numChannels > 0 && mapMirrored(memfd_create("delayTutorial", MFD_CLOEXEC), numChannels, size))
+    {
+        clear();
+        return;
+    }
+   #endif
+
+    //fallback: a copy of the start of the buffer lives after the end
+    guardSize = windowSize;
+    guardedData.allocate((size_t) numChannels * (size_t) (size + guardSize), true);
+    useGuardedChannels(guardedData.get());
+}
+
+bool MirroredRingBuffer::setSizeOnDisk(int newNumChannels, int minNumSamples, int newWindowSize, const juce::File& file)
+{
+    setChannelSize(newNumChannels, minNumSamples, newWindowSize);
+
+    if (numChannels == 0 || ! file.getParentDirectory().createDirectory())
+        return false;
+
+    //a new file reads back as zeros, so there's no need to clear it (which would
+    //load every page of it into memory)
+   #if JUCE_LINUX
+    if (mapMirrored(open(file.getFullPathName().toRawUTF8(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600), numChannels, size))
+    {
+        backingFile = file;
+        return true;
+    }
+   #endif
+
+    guardSize = windowSize;
+    auto totalBytes = (juce::int64) numChannels * (juce::int64) (size + guardSize) * (juce::int64) sizeof(float);
+
+    //grow the file to full size by writing its last byte
+    file.deleteFile();
+    {
+        juce::FileOutputStream stream(file);
+
+        if (! stream.openedOk() || ! stream.setPosition(totalBytes - 1) || ! stream.writeByte(0))
+            return false;
+    }
+
+    backingFile = file;
+    mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite);
+
+    if (mappedFile->getData() == nullptr || (juce::int64) mappedFile->getSize() < totalBytes)
+    {
+        release();
+        return false;
+    }
+
+    useGuardedChannels(static_cast<float*>(mappedFile->getData()));
+    return true;
+}
+
+void MirroredRingBuffer::release()
+{
+    unmap();
+    mappedFile.reset();
+    guardedData.free();
+
+    if (backingFile != juce::File())
+        backingFile.deleteFile();
+
+    backingFile = juce::File();
+    channels.clear();
+    numChannels = 0;
+    size = 0;
+    windowSize = 0;
+    guardSize = 0;
+}
+
+void MirroredRingBuffer::clear()
+{
+    //the mirrored half shares memory with the first half, so only clear that.
+    //on disk this loads every page of the file
+    for (auto* channel : channels)
+        juce::FloatVectorOperations::clear(channel, size + guardSize);
+}
+
+void MirroredRingBuffer::clear(int position, int numSamples) noexcept
+{
+    position &= getMask();
+    numSamples = juce::jmin(numSamples, size);
+
+    //up to the end and then from the start, keeping the guard region the same as write() does
+    while (numSamples > 0)
+    {
+        auto numToEnd = juce::jmin(numSamples, size - position);
+
+        for (auto* channel : channels)
+        {
+            juce::FloatVectorOperations::clear(channel + position, numToEnd);
+
+            if (position < guardSize)
+                juce::FloatVectorOperations::clear(channel + size + position, juce::jmin(position + numToEnd, guardSize) - position);
+        }
+
+        numSamples -= numToEnd;
+        position = 0;
+    }
+}
+
+void MirroredRingBuffer::write(int channel, int position, const float* source, int numSamples) noexcept
+{
+    jassert(numSamples <= windowSize);
+
+    position &= getMask();
+    auto* data = channels[(size_t) channel];
+
+    juce::FloatVectorOperations::copy(data + position, source, numSamples);
+
+    if (guardSize == 0)
+        return;
+
+    //keep the guard region and the start of the buffer the same
+    auto end = position + numSamples;
+
+    if (end > size)
+        juce::FloatVectorOperations::copy(data, data + size, end - size);
+
+    if (position < guardSize)
+        juce::FloatVectorOperations::copy(data + size + position, data + position, juce::jmin(end, guardSize) - position);
+}
+
+void MirroredRingBuffer::setChannelSize(int newNumChannels, int minNumSamples, int newWindowSize)
+{
+    release();
+
+    numChannels = juce::jmax(0, newNumChannels);
+    windowSize = juce::jmax(1, newWindowSize);
+    size = juce::nextPowerOfTwo(juce::jmax(minNumSamples, windowSize));
+
+   #if JUCE_LINUX
+    //each mapping has to be a whole number of pages
+    auto samplesPerPage = (int) (sysconf(_SC_PAGESIZE) / (long) sizeof(float));
+    size = juce::jmax(size, juce::nextPowerOfTwo(samplesPerPage));
+   #endif
+}
+
+void MirroredRingBuffer::useGuardedChannels(float* data)
+{
+    channels.resize((size_t) numChannels);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        channels[(size_t) channel] = data + (size_t) channel * (size_t) (size + guardSize);
+}
+
+bool MirroredRingBuffer::mapMirrored(int fd, int newNumChannels, int numSamples)
+{
+   #if JUCE_LINUX
+    if (fd < 0)
+        return false;
+
+    auto channelBytes = (size_t) numSamples * sizeof(float);
+    auto totalBytes = channelBytes * (size_t) newNumChannels;
+
+    if (ftruncate(fd, (off_t) totalBytes) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    //reserve address space for two copies of every channel, then map each
+    //channel's part of the file into both halves of its slot
+    auto* region = mmap(nullptr, totalBytes * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    mappedRegion = region;
+    mappedBytes = totalBytes * 2;
+    channels.resize((size_t) newNumChannels);
+
+    for (int channel = 0; channel < newNumChannels; ++channel)
+    {
+        auto* slot = static_cast<char*>(region) + channelBytes * 2 * (size_t) channel;
+        auto offset = (off_t) (channelBytes * (size_t) channel);
+
+        auto* first = mmap(slot, channelBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset);
+        auto* second = mmap(slot + channelBytes, channelBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset);
+
+        if (first == MAP_FAILED || second == MAP_FAILED)
+        {
+            close(fd);
+            unmap();
+            return false;
+        }
+
+        channels[(size_t) channel] = reinterpret_cast<float*>(slot);
+    }
+
+    //the mappings keep the memory alive
+    close(fd);
+    windowSize = numSamples;
+    return true;
+   #else
+    juce::ignoreUnused(fd, newNumChannels, numSamples);
+    return false;
+   #endif
+}
+
+void MirroredRingBuffer::unmap()
+{
+   #if JUCE_LINUX
+    if (mappedRegion != nullptr)
+        munmap(mappedRegion, mappedBytes);
+   #endif
+
+    mappedRegion = nullptr;
+    mappedBytes = 0;
+    channels.clear();
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    MirroredRingBuffer.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Power-of-two circular buffer that always has a contiguous window after
+    any position, so reads and writes never have to be split at the end.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Each channel holds a power-of-two number of samples, so positions wrap
+    with a mask instead of a modulo or a branch.
+
+    On Linux the channel memory is mapped twice back to back (memfd + mmap),
+    so the sample after the last one is the first one again and the whole
+    buffer is one contiguous window. Everywhere else (or if the mapping
+    fails) each channel gets a guard region after the end that mirrors the
+    start, and write() keeps the two copies in sync.
+
+    The samples can also live in a memory mapped file instead of RAM, for
+    delays that are too long to keep in memory. Pages are then only loaded
+    when they're touched, see DelayPrefetcher.
+*/
+class MirroredRingBuffer
+{
+public:
+    //per-sample access for the read kernels, wraps any index (even negative ones)
+    struct Reader
+    {
+        const float* data;
+        int mask;
+
+        float operator[](int index) const noexcept { return data[index & mask]; }
+    };
+
+    MirroredRingBuffer() = default;
+    ~MirroredRingBuffer();
+
+    //allocate at least minNumSamples per channel, with at least windowSize
+    //contiguous samples readable from any position. clears the contents
+    void setSize(int numChannels, int minNumSamples, int windowSize);
+    //same, but the samples are stored in backingFile (which gets created, and
+    //deleted again on release). returns false if the file couldn't be mapped
+    bool setSizeOnDisk(int numChannels, int minNumSamples, int windowSize, const juce::File& backingFile);
+    //free all memory (and the backing file)
+    void release();
+    //zero every channel
+    void clear();
+    //zero numSamples of every channel from position on, wrapping at the end
+    void clear(int position, int numSamples) noexcept;
+
+    int getNumChannels() const noexcept { return numChannels; }
+    //number of samples before positions wrap (always a power of two)
+    int getNumSamples() const noexcept { return size; }
+    //AND a position with this to wrap it, works for negative positions too
+    int getMask() const noexcept { return size - 1; }
+    //how many samples are contiguous after any position
+    int getWindowSize() const noexcept { return windowSize; }
+    bool isDoubleMapped() const noexcept { return mappedRegion != nullptr; }
+    bool isOnDisk() const noexcept { return backingFile != juce::File(); }
+
+    //start of the channel, for per-sample reads using (index & getMask())
+    const float* getReadPointer(int channel) const noexcept { return channels[(size_t) channel]; }
+    Reader getReader(int channel) const noexcept { return { channels[(size_t) channel], getMask() }; }
+    //contiguous window starting at the (wrapped) position. it's getWindowSize() + 1 samples long at least,
+    //as a wrapped position is never past the last sample
+    const float* getReadPointer(int channel, int position) const noexcept { return channels[(size_t) channel] + (position & getMask()); }
+
+    //copy numSamples (up to the window size) in at position, in one pass
+    void write(int channel, int position, const float* source, int numSamples) noexcept;
+
+private:
+    void setChannelSize(int numChannels, int minNumSamples, int windowSize);
+    bool mapMirrored(int fd, int numChannels, int numSamples);
+    void useGuardedChannels(float* data);
+    void unmap();
+
+    std::vector<float*> channels;
+    int numChannels{ 0 };
+    int size{ 0 };
+    int windowSize{ 0 };
+
+    //double mapped memory (linux)
+    void* mappedRegion{ nullptr };
+    size_t mappedBytes{ 0 };
+
+    //guard copy fallback
+    juce::HeapBlock<float> guardedData;
+    int guardSize{ 0 };
+
+    //disk storage
+    juce::File backingFile;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MirroredRingBuffer)
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    MultiTapDelay.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Up to 64 taps reading from one shared delay buffer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Every tap has its own time, gain, pan and one pole lowpass. Tap settings
+    and filter states are stored structure-of-arrays and processed a SIMD
+    register's worth of taps at a time, so the tap loop runs in vector lanes.
+    Unused taps have zero gain, so they cost time but never change the output.
+
+    Mono and stereo taps get panned. Surround and ambisonic layouts have
+    no left and right that mean the same thing in every channel, so there
+    every channel gets each tap at the level it would have panned centre. The filter states for every
+    channel are one array, sized by prepare().
+*/
+class MultiTapDelay
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int maxTaps = 64;
+
+    MultiTapDelay() { clearTaps(); }
+
+    //allocates the filter states, so never on the audio thread
+    void prepare(double newSampleRate, int newNumChannels)
+    {
+        sampleRate = newSampleRate;
+        numChannels = newNumChannels;
+        states.resize((size_t) numChannels);
+        reset();
+    }
+
+    //clear the filter states
+    void reset()
+    {
+        for (auto& channelStates : states)
+            for (auto& state : channelStates)
+                state = Vec::expand(0.0f);
+    }
+
+    //turn every tap off
+    void clearTaps()
+    {
+        for (int tap = 0; tap < maxTaps; ++tap)
+            setTap(tap, 1.0f, 0.0f, 0.0f, 20000.0f);
+
+        numTaps = 0;
+    }
+
+    //delay is in samples, pan goes from -1 (left) to 1 (right), cutoff in Hz
+    void setTap(int index, float delaySamples, float gain, float pan, float cutoff)
+    {
+        jassert(juce::isPositiveAndBelow(index, maxTaps));
+
+        delayInts[(size_t) index] = juce::jmax(1, (int) delaySamples);
+        levels[(size_t) index] = gain;
+
+        //equal power pan
+        auto angle = (juce::jlimit(-1.0f, 1.0f, pan) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+        setLane(gains[0], index, gain * std::cos(angle));
+        setLane(gains[1], index, gain * std::sin(angle));
+        setLane(gains[2], index, gain * juce::MathConstants<float>::sqrt2 * 0.5f);
+
+        auto fc = juce::jlimit(20.0f, (float) sampleRate * 0.49f, cutoff);
+        setLane(coefficients, index, 1.0f - std::exp(-juce::MathConstants<float>::twoPi * fc / (float) sampleRate));
+
+        numTaps = juce::jmax(numTaps, index + 1);
+    }
+
+    int getNumTaps() const noexcept { return numTaps; }
+
+    //shortest audible tap in samples, used to size tiles so no tap reads what is still being written
+    int getShortestDelay() const noexcept
+    {
+        auto shortest = std::numeric_limits<int>::max();
+
+        for (int tap = 0; tap < numTaps; ++tap)
+            if (levels[(size_t) tap] != 0.0f)
+                shortest = juce::jmin(shortest, delayInts[(size_t) tap]);
+
+        return shortest;
+    }
+
+    //sum of all taps for one channel into dest. position is the write position of dest[0].
+    //works with any delay buffer that has a getReader() (see MirroredRingBuffer::Reader)
+    template <typename RingBuffer>
+    void process(const RingBuffer& line, int channel, int position, float* dest, int numSamples) noexcept
+    {
+        auto reader = line.getReader(channel);
+        auto activeGroups = (numTaps + (int) Vec::size() - 1) / (int) Vec::size();
+
+        jassert(juce::isPositiveAndBelow(channel, numChannels));
+        //only stereo gets panned, mono and wider layouts take the centre gains
+        auto& channelGains = gains[(size_t) (numChannels == 2 ? channel : 2)];
+        auto& channelStates = states[(size_t) channel];
+
+        alignas(Vec) float taps[Vec::size()];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto sum = Vec::expand(0.0f);
+
+            for (int group = 0; group < activeGroups; ++group)
+            {
+                //gather this group's taps, then filter and weight them all at once
+                for (size_t lane = 0; lane < Vec::size(); ++lane)
+                    taps[lane] = reader[position + i - delayInts[(size_t) group * Vec::size() + lane]];
+
+                auto& state = channelStates[(size_t) group];
+                state += coefficients[(size_t) group] * (Vec::fromRawArray(taps) - state);
+                sum += state * channelGains[(size_t) group];
+            }
+
+            dest[i] = sum.sum();
+        }
+    }
+
+private:
+    static constexpr size_t numGroups = (size_t) maxTaps / Vec::size();
+    using Lanes = std::array<Vec, numGroups>;
+
+    static void setLane(Lanes& lanes, int index, float value)
+    {
+        lanes[(size_t) index / Vec::size()].set((size_t) index % Vec::size(), value);
+    }
+
+    double sampleRate{ 44100.0 };
+    int numChannels{ 0 };
+    int numTaps{ 0 };
+
+    std::array<int, maxTaps> delayInts;
+    std::array<float, maxTaps> levels;
+    //gain for the left and right channels (pan is folded in), and centre for mono and wider layouts
+    std::array<Lanes, 3> gains;
+    //one pole lowpass
+    Lanes coefficients;
+    //per channel
+    std::vector<Lanes> states;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiTapDelay)
+};
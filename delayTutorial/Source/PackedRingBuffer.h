@@ -0,0 +1,342 @@
+/*
+  ==============================================================================
+
+    PackedRingBuffer.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Delay buffer that stores its samples in fewer than 32 bits.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//how the delay history is stored in memory
+enum class DelaySampleFormat
+{
+    Float32,
+    Float16,
+    Int16,
+    BlockFloat,
+};
+
+//==============================================================================
+/*
+    Codecs for PackedRingBuffer. Each one has:
+      Sample           - what gets stored per sample
+      blockShift       - samples per shared scale is (1 << blockShift), 0 if there is no scale
+      State            - whatever the encoder has to remember between calls
+      encode()         - packs numSamples floats in at position (never across the end of the buffer)
+      decode()         - unpacks the sample at index
+
+    encode() loops are straight element-wise maths so the compiler can vectorize them.
+*/
+namespace DelayCodecs
+{
+    //reinterpret the bits of a float as an int or the other way round
+    template <typename To, typename From>
+    inline To bitCast(From value) noexcept
+    {
+        static_assert(sizeof(To) == sizeof(From), "sizes have to match");
+        To result;
+        std::memcpy(&result, &value, sizeof(To));
+        return result;
+    }
+
+    //IEEE half float. 11 bit mantissa (about 73 dB SNR at any level), 2 bytes per sample
+    struct Float16
+    {
+        using Sample = juce::uint16;
+        static constexpr int blockShift = 0;
+        struct State {};
+
+        static juce::uint16 fromFloat(float value) noexcept
+        {
+            //round to nearest even, anything too small for a normal half becomes a subnormal
+            //(see Fabian Giesen's float_to_half_fast3_rtne). values are clamped first so
+            //there are no infinities or NaNs to worry about
+            auto bits = bitCast<juce::uint32>(juce::jlimit(-65504.0f, 65504.0f, value));
+            auto sign = (bits >> 16) & 0x8000u;
+            bits &= 0x7fffffffu;
+
+            constexpr juce::uint32 denormMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+            auto subnormal = bitCast<juce::uint32>(bitCast<float>(bits) + bitCast<float>(denormMagicBits)) - denormMagicBits;
+
+            auto rounded = bits + ((juce::uint32) (15 - 127) << 23) + 0xfffu + ((bits >> 13) & 1u);
+            auto normal = rounded >> 13;
+
+            return (juce::uint16) (sign | (bits < (113u << 23) ? subnormal : normal));
+        }
+
+        static float toFloat(juce::uint16 half) noexcept
+        {
+            constexpr juce::uint32 shiftedExponent = 0x7c00u << 13;
+            auto bits = (juce::uint32) (half & 0x7fffu) << 13;
+            auto exponent = bits & shiftedExponent;
+            bits += (juce::uint32) (127 - 15) << 23;
+
+            //zero and subnormals need renormalising, there are no infinities (see fromFloat)
+            auto value = exponent == 0 ? bitCast<float>(bits + (1u << 23)) - bitCast<float>(113u << 23)
+                                       : bitCast<float>(bits);
+
+            return (half & 0x8000u) != 0 ? -value : value;
+        }
+
+        static void encode(const float* source, Sample* samples, float*, int, int numSamples, State&) noexcept
+        {
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = fromFloat(source[i]);
+        }
+
+        static float decode(const Sample* samples, const float*, int index) noexcept
+        {
+            return toFloat(samples[index]);
+        }
+    };
+
+    //16 bit fixed point with triangular dither. full scale is +-4 so the feedback loop has
+    //12 dB of headroom before it clips, which leaves about 77 dB SNR for a full scale signal
+    struct Int16
+    {
+        using Sample = juce::int16;
+        static constexpr int blockShift = 0;
+        static constexpr float fullScale = 4.0f;
+
+        struct State
+        {
+            juce::uint32 counter{ 0 };
+        };
+
+        //hash of a counter rather than a running random generator, so every sample
+        //gets its noise independently and the loop still vectorizes
+        static float noise(juce::uint32 x) noexcept
+        {
+            x ^= x >> 16;
+            x *= 0x7feb352du;
+            x ^= x >> 15;
+            x *= 0x846ca68bu;
+            x ^= x >> 16;
+
+            //two uniform values in one hash, their difference is triangular in -1..1 LSB
+            return (float) (x & 0xffffu) * (1.0f / 65536.0f) - (float) (x >> 16) * (1.0f / 65536.0f);
+        }
+
+        static void encode(const float* source, Sample* samples, float*, int, int numSamples, State& state) noexcept
+        {
+            constexpr auto toInt = 32767.0f / fullScale;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto value = source[i] * toInt + noise(state.counter + (juce::uint32) i);
+                samples[i] = (Sample) juce::roundToInt(juce::jlimit(-32767.0f, 32767.0f, value));
+            }
+
+            state.counter += (juce::uint32) numSamples;
+        }
+
+        static float decode(const Sample* samples, const float*, int index) noexcept
+        {
+            return (float) samples[index] * (fullScale / 32767.0f);
+        }
+    };
+
+    //8 bit mantissas sharing a power of two scale per 16 samples (10 bits per sample).
+    //about 48 dB SNR, but relative to the block, so quiet passages keep their detail
+    struct BlockFloat
+    {
+        using Sample = juce::int8;
+        static constexpr int blockShift = 4;
+        static constexpr int blockSize = 1 << blockShift;
+        struct State {};
+
+        //smallest power of two step that fits peak into 127 steps
+        static float stepFor(float peak) noexcept
+        {
+            int exponent = 0;
+            std::frexp(juce::jmax(peak, 1.0e-12f) / 127.0f, &exponent);
+            return std::ldexp(1.0f, exponent);
+        }
+
+        static void encode(const float* source, Sample* samples, float* scales, int position, int numSamples, State&) noexcept
+        {
+            //writes always move forwards, so a block is either started fresh at its first
+            //sample, or continued. if the new part is louder the part already written is
+            //requantized to the bigger step, which is just a shift as steps are powers of two.
+            //a block continued after its first part was cleared to 0 starts fresh too
+            for (int done = 0; done < numSamples;)
+            {
+                auto offset = (position + done) & (blockSize - 1);
+                auto count = juce::jmin(blockSize - offset, numSamples - done);
+                auto* block = samples + done - offset;
+                auto& scale = scales[(position + done) >> blockShift];
+
+                auto peak = 0.0f;
+                for (int i = 0; i < count; ++i)
+                    peak = juce::jmax(peak, std::abs(source[done + i]));
+
+                auto step = stepFor(peak);
+                auto continued = offset > 0 && std::any_of(block, block + offset, [] (Sample sample) { return sample != 0; });
+
+                if (continued && scale >= step)
+                {
+                    step = scale;
+                }
+                else if (continued)
+                {
+                    auto ratio = scale / step;
+
+                    for (int i = 0; i < offset; ++i)
+                        block[i] = (Sample) juce::roundToInt((float) block[i] * ratio);
+                }
+
+                scale = step;
+
+                auto toInt = 1.0f / step;
+                for (int i = 0; i < count; ++i)
+                    block[offset + i] = (Sample) juce::jlimit(-127, 127, juce::roundToInt(source[done + i] * toInt));
+
+                done += count;
+            }
+        }
+
+        static float decode(const Sample* samples, const float* scales, int index) noexcept
+        {
+            return (float) samples[index] * scales[index >> blockShift];
+        }
+    };
+}
+
+//==============================================================================
+/**
+    Power-of-two circular delay buffer that stores each sample with Codec
+    (see DelayCodecs), to fit more delay history in less memory.
+
+    It isn't mirrored, a write that crosses the end is encoded in two parts,
+    but reads go through a Reader with the same interface as
+    MirroredRingBuffer::Reader, so all the read kernels work with either.
+*/
+template <typename Codec>
+class PackedRingBuffer
+{
+public:
+    using Sample = typename Codec::Sample;
+
+    struct Reader
+    {
+        const Sample* samples;
+        const float* scales;
+        int mask;
+
+        float operator[](int index) const noexcept { return Codec::decode(samples, scales, index & mask); }
+    };
+
+    PackedRingBuffer() = default;
+
+    //allocate at least minNumSamples per channel and clear it
+    void setSize(int newNumChannels, int minNumSamples)
+    {
+        numChannels = juce::jmax(0, newNumChannels);
+        size = juce::nextPowerOfTwo(juce::jmax(minNumSamples, 1 << Codec::blockShift));
+
+        auto numScales = Codec::blockShift > 0 ? size >> Codec::blockShift : 1;
+
+        samples.assign((size_t) numChannels, std::vector<Sample>((size_t) size, Sample{}));
+        scales.assign((size_t) numChannels, std::vector<float>((size_t) numScales, 0.0f));
+        states.assign((size_t) numChannels, typename Codec::State{});
+    }
+
+    //zero every channel
+    void clear()
+    {
+        for (auto& channelSamples : samples)
+            std::fill(channelSamples.begin(), channelSamples.end(), Sample{});
+
+        for (auto& channelScales : scales)
+            std::fill(channelScales.begin(), channelScales.end(), 0.0f);
+    }
+
+    //zero numSamples of every channel from position on, wrapping at the end. the scales of the
+    //blocks it covers go back to 0 as well, like clear(), or the next write into one would carry
+    //on with whatever step it had before. a block it only covers part of keeps its scale, the rest
+    //of the block still decodes with it
+    void clear(int position, int numSamples) noexcept
+    {
+        position &= getMask();
+        numSamples = juce::jmin(numSamples, size);
+
+        auto numToEnd = juce::jmin(numSamples, size - position);
+
+        for (auto& channelSamples : samples)
+        {
+            std::fill_n(channelSamples.begin() + position, numToEnd, Sample{});
+            std::fill_n(channelSamples.begin(), numSamples - numToEnd, Sample{});
+        }
+
+        if constexpr (Codec::blockShift > 0)
+        {
+            constexpr int blockSize = 1 << Codec::blockShift;
+            auto firstBlock = (position + blockSize - 1) >> Codec::blockShift;
+            auto endBlock = (position + numSamples) >> Codec::blockShift;
+            auto scaleMask = (size >> Codec::blockShift) - 1;
+
+            for (auto& channelScales : scales)
+                for (auto block = firstBlock; block < endBlock; ++block)
+                    channelScales[(size_t) (block & scaleMask)] = 0.0f;
+        }
+    }
+
+    void release()
+    {
+        samples.clear();
+        scales.clear();
+        states.clear();
+        numChannels = 0;
+        size = 0;
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+    int getNumSamples() const noexcept { return size; }
+    int getMask() const noexcept { return size - 1; }
+    bool isOnDisk() const noexcept { return false; }
+
+    //bytes used by the delay history, for comparing formats
+    size_t getMemoryUsage() const noexcept
+    {
+        auto numScales = scales.empty() ? 0 : scales[0].size();
+        return (size_t) numChannels * ((size_t) size * sizeof(Sample) + numScales * sizeof(float));
+    }
+
+    Reader getReader(int channel) const noexcept
+    {
+        return { samples[(size_t) channel].data(), scales[(size_t) channel].data(), getMask() };
+    }
+
+    //pack numSamples in at position, in two parts if it crosses the end
+    void write(int channel, int position, const float* source, int numSamples) noexcept
+    {
+        position &= getMask();
+
+        auto* channelSamples = samples[(size_t) channel].data();
+        auto* channelScales = scales[(size_t) channel].data();
+        auto& state = states[(size_t) channel];
+
+        auto numToEnd = juce::jmin(numSamples, size - position);
+        Codec::encode(source, channelSamples + position, channelScales, position, numToEnd, state);
+
+        if (numToEnd < numSamples)
+            Codec::encode(source + numToEnd, channelSamples, channelScales, 0, numSamples - numToEnd, state);
+    }
+
+private:
+    int numChannels{ 0 };
+    int size{ 0 };
+
+    std::vector<std::vector<Sample>> samples;
+    std::vector<std::vector<float>> scales;
+    std::vector<typename Codec::State> states;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PackedRingBuffer)
+};
@@ -11,11 +11,13 @@
 
 //==============================================================================
 DelayTutorialAudioProcessorEditor::DelayTutorialAudioProcessorEditor (DelayTutorialAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), parameterEditor (p)
 {
+    addAndMakeVisible(parameterEditor);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (400, 500);
 }
 
 DelayTutorialAudioProcessorEditor::~DelayTutorialAudioProcessorEditor()
@@ -27,14 +29,11 @@ void DelayTutorialAudioProcessorEditor::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    g.setColour (juce::Colours::white);
-    g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
 }
 
 void DelayTutorialAudioProcessorEditor::resized()
 {
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
+    parameterEditor.setBounds(getLocalBounds().reduced(10));
 }
@@ -29,5 +29,9 @@ private:
     // access the processor object that created it.
     DelayTutorialAudioProcessor& audioProcessor;
 
+    //PARAMETERS
+    //JUCE's generic controls for all the delay's parameters, until it has a layout of its own
+    juce::GenericAudioProcessorEditor parameterEditor;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayTutorialAudioProcessorEditor)
 };
@@ -20,13 +20,14 @@ DelayTutorialAudioProcessor::DelayTutorialAudioProcessor()
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                           //when plugin initializes it needs list of parameters
-                       ), params (*this, nullptr, "Parameters", createParameters())
+                       ), params (*this, nullptr, "Parameters", ParameterTable::createLayout(parameterTable))
 #endif
 {
 }
 
 DelayTutorialAudioProcessor::~DelayTutorialAudioProcessor()
 {
+    storeBuilder.stop();
 }
 
 //==============================================================================
@@ -64,7 +65,8 @@ bool DelayTutorialAudioProcessor::isMidiEffect() const
 
 double DelayTutorialAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    auto sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    return getTailSamples(sampleRate) / sampleRate;
 }
 
 int DelayTutorialAudioProcessor::getNumPrograms()
@@ -94,12 +96,64 @@ void DelayTutorialAudioProcessor::changeProgramName (int index, const juce::Stri
 //==============================================================================
 void DelayTutorialAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    //set circular buffer to hold 2 sec of audio
-    auto delayBufferSize = sampleRate * 2.0;
-    delayBuffer.setSize(getNumOutputChannels(), (int)delayBufferSize);
+    //scratch space for the fractional read, sized once here so processBlock never allocates
+    maxBlockSize = juce::jmax(1, samplesPerBlock);
+
+    delayTimes.assign((size_t) maxBlockSize, 0.0f);
+    delayInts.assign((size_t) maxBlockSize, 0);
+    delayFracs.assign((size_t) maxBlockSize, 0.0f);
+    feedbackGains.assign((size_t) maxBlockSize, 0.0f);
+    delayedTile.setSize(getTotalNumOutputChannels(), tileSize);
+    feedbackTile.setSize(getTotalNumOutputChannels(), tileSize);
+    crossfadeBuffer.setSize(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()), maxBlockSize);
+    crossfadeLength = juce::jmax(1, (int) (sampleRate * 0.05));
+    scheduler.setGridSize(juce::jmin(tileSize, maxBlockSize));
+    scheduler.reset();
+
+    //drop anything that was being built for the old settings
+    storeBuilder.stop();
+    storeBuilder.start();
+
+    auto spec = getStoreSpec(getRequestedStorage(), sampleRate);
+    lastRequest = spec.choice;
+
+    fadingStore.reset();
+    nextStore.reset();
+    crossfadeRemaining = 0;
+
+    if (delayStore == nullptr || delayStore->spec.numChannels != spec.numChannels || delayStore->spec.windowSize < spec.windowSize)
+    {
+        //nothing to keep playing from (or it can't take the new block size), and the audio
+        //thread isn't running yet, so just build it here
+        delayStore = createStore(spec);
+    }
+    else if (! delayStore->fits(spec))
+    {
+        //needs more history at the new sample rate. keep the old one going and crossfade
+        //over once the background thread has built the bigger one (and the history's been copied in)
+        storeBuilder.request(spec);
+    }
+
+    reverb.prepare(sampleRate);
+    silentSamples = 0;
+    idle = false;
+
+    //force the taps to be laid out for the new sample rate
+    delayStore->multiTap.prepare(sampleRate, delayStore->spec.numChannels);
+    delayStore->tapLayout.fill(-1.0f);
+    delayStore->granular.prepare(sampleRate);
+    delayStore->prepareParts(sampleRate);
 
     //reset linear smoothed values
-    g.reset(sampleRate, 0.005);
+    feedbackSmoothed.reset(sampleRate, 0.005);
+    delayTimeSmoothed.reset(sampleRate, 0.05);
+    delayTimeSmoothed.setCurrentAndTargetValue(paramValues.get(Param::DelayMs));
+
+    //workers only for layouts wide enough to be split up
+    if (getTotalNumOutputChannels() >= minParallelChannels)
+        workers.start(ChannelWorkers::getAvailableWorkers());
+    else
+        workers.stop();
 
 }
 
@@ -107,6 +161,188 @@ void DelayTutorialAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    //the delay history is the big one, prepareToPlay builds it again
+    storeBuilder.stop();
+    workers.stop();
+    fadingStore.reset();
+    nextStore.reset();
+    delayStore.reset();
+    reverb.release();
+}
+
+DelayTutorialAudioProcessor::StorageChoice DelayTutorialAudioProcessor::getRequestedStorage() const
+{
+    auto storage = paramValues.getChoice<DelayStorage>(Param::Storage);
+
+    //disk is always float32
+    if (storage == DelayStorage::Disk)
+        return { storage, DelaySampleFormat::Float32 };
+
+    return { storage, paramValues.getChoice<DelaySampleFormat>(Param::Format) };
+}
+
+DelayTutorialAudioProcessor::StoreSpec DelayTutorialAudioProcessor::getStoreSpec(StorageChoice choice, double sampleRate) const
+{
+    return { choice, getTotalNumOutputChannels(), getCapacity(choice.storage, sampleRate), maxBlockSize, sampleRate };
+}
+
+int DelayTutorialAudioProcessor::getCapacity(DelayStorage storage, double sampleRate) const
+{
+    //enough history for the longest delay the parameter allows, plus the samples the
+    //lagrange read looks at around it (see updateDelayTimes)
+    auto longestDelay = storage == DelayStorage::Disk
+                      ? (double) getSpec(Param::LongDelay).max * sampleRate
+                      : (double) getSpec(Param::DelayMs).max; //DELAYMS counts samples
+
+    return (int) std::ceil(longestDelay) + 4;
+}
+
+std::unique_ptr<DelayTutorialAudioProcessor::DelayStore> DelayTutorialAudioProcessor::createStore(const StoreSpec& spec)
+{
+    auto store = std::make_unique<DelayStore>();
+    store->spec = spec;
+    store->choice = spec.choice;
+    store->thiranStates.assign((size_t) spec.numChannels, 0.0f);
+    store->multiTap.prepare(spec.sampleRate, spec.numChannels);
+    store->tapLayout.fill(-1.0f);
+    store->granular.prepare(spec.sampleRate);
+    store->prepareParts(spec.sampleRate);
+
+    if (spec.choice.storage == DelayStorage::Disk)
+    {
+        //each store gets its own file, the buffer deletes it again when released
+        auto file = juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile("delayTutorial", ".delay");
+
+        if (store->buffer.setSizeOnDisk(spec.numChannels, spec.capacity, spec.windowSize, file))
+        {
+            //keep a second ahead loaded
+            store->prefetcher.start((int) spec.sampleRate);
+            return store;
+        }
+
+        //couldn't map the file, stay in memory (with however much the memory mode needs)
+        store->choice = { DelayStorage::Memory, DelaySampleFormat::Float32 };
+        store->spec.capacity = getCapacity(DelayStorage::Memory, spec.sampleRate);
+    }
+
+    //sizes get rounded up to a power of two. the float one always has a whole block of
+    //contiguous samples after any position
+    switch (store->choice.format)
+    {
+        case DelaySampleFormat::Float16:
+            store->float16Buffer.setSize(spec.numChannels, store->spec.capacity);
+            break;
+
+        case DelaySampleFormat::Int16:
+            store->int16Buffer.setSize(spec.numChannels, store->spec.capacity);
+            break;
+
+        case DelaySampleFormat::BlockFloat:
+            store->blockFloatBuffer.setSize(spec.numChannels, store->spec.capacity);
+            break;
+
+        case DelaySampleFormat::Float32:
+        default:
+            store->buffer.setSize(spec.numChannels, store->spec.capacity, spec.windowSize);
+            break;
+    }
+
+    return store;
+}
+
+void DelayTutorialAudioProcessor::swapInReadyStore()
+{
+    //wait for the last crossfade to finish before starting another
+    if (fadingStore != nullptr)
+        return;
+
+    if (nextStore == nullptr)
+    {
+        auto ready = storeBuilder.takeReady();
+
+        if (ready == nullptr)
+            return;
+
+        //a store built for a smaller block size can't be used, prepareToPlay builds a new one anyway
+        if (ready->spec.windowSize < maxBlockSize || ready->spec.numChannels != delayStore->spec.numChannels)
+        {
+            storeBuilder.retire(std::move(ready));
+            return;
+        }
+
+        //the new store starts out silent, so the repeats already in the old one would fade out with it.
+        //everything the old one holds (apart from history still waiting to be zeroed) gets copied over
+        //first, a piece per slice. not to or from disk, that would load the file on the audio thread,
+        //so a disk store still fades its repeats out or in
+        nextStore = std::move(ready);
+        seedPosition = delayStore->writePosition;
+        seedSamples = delayStore->choice.storage == DelayStorage::Disk || nextStore->choice.storage == DelayStorage::Disk
+                    ? 0
+                    : delayStore->getNumSamples() - delayStore->staleSamples;
+    }
+
+    //a bounded piece per slice, so carrying a long history over never holds one up
+    if (! seedNextStore(juce::jmax(2 * tileSize, seedSamplesPerSlice / juce::jmax(1, delayStore->spec.numChannels))))
+        return;
+
+    //carry on from the same place in the history
+    nextStore->writePosition = delayStore->writePosition & (nextStore->getNumSamples() - 1);
+
+    fadingStore = std::move(delayStore);
+    delayStore = std::move(nextStore);
+    crossfadeRemaining = crossfadeLength;
+}
+
+bool DelayTutorialAudioProcessor::seedNextStore(int maxSamples)
+{
+    auto& from = *delayStore;
+    auto& to = *nextStore;
+
+    //whatever's been written since the last piece has to go across too. the oldest of it is dropped
+    //if that's more than the new store holds, or more than the old one has that isn't stale
+    auto written = (from.writePosition - seedPosition) & (from.getNumSamples() - 1);
+    seedSamples = juce::jmin(seedSamples + written, to.getNumSamples(), from.getNumSamples() - from.staleSamples);
+    seedPosition = from.writePosition;
+
+    auto numSamples = juce::jmin(maxSamples, seedSamples);
+
+    if (numSamples > 0)
+    {
+        auto position = from.writePosition - seedSamples;
+
+        from.withLine([&] (auto& fromLine)
+        {
+            to.withLine([&] (auto& toLine) { copyHistory(fromLine, toLine, position, numSamples); });
+        });
+
+        seedSamples -= numSamples;
+    }
+
+    return seedSamples == 0;
+}
+
+template <typename FromLine, typename ToLine>
+void DelayTutorialAudioProcessor::copyHistory(FromLine& from, ToLine& to, int position, int numSamples)
+{
+    //the crossfade buffer isn't in use until the swap, and every store can take a write that long in one go
+    auto* decoded = crossfadeBuffer.getWritePointer(0);
+    auto pieceSize = crossfadeBuffer.getNumSamples();
+
+    for (int channel = 0; channel < from.getNumChannels(); ++channel)
+    {
+        auto reader = from.getReader(channel);
+
+        //in order, so the packed formats encode it like any other run of blocks
+        for (int start = 0; start < numSamples; start += pieceSize)
+        {
+            auto length = juce::jmin(pieceSize, numSamples - start);
+
+            for (int i = 0; i < length; ++i)
+                decoded[i] = reader[position + start + i];
+
+            to.write(channel, position + start, decoded, length);
+        }
+    }
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -117,11 +353,10 @@ bool DelayTutorialAudioProcessor::isBusesLayoutSupported (const BusesLayout& lay
     return true;
   #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    //mono and stereo, and surround and ambisonic layouts up to 16 channels
+    if (! ChannelLayouts::isSupported(layouts.getMainOutputChannelSet()))
         return false;
 
     // This checks if the input layout matches the output layout
@@ -144,110 +379,447 @@ void DelayTutorialAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    //nothing to play through until prepareToPlay has run, or while it's all silent
+    if (delayStore == nullptr || isIdle(buffer))
+        return;
+
+    //work through the block in control rate slices (never longer than a tile or the scratch buffers,
+    //which also covers hosts sending bigger blocks than promised), reading the parameters again for
+    //each one so automation isn't stepped by the host's buffer size. the slice just points into the host buffer
+    scheduler.process(buffer.getNumSamples(), midiMessages, [&] (int startSample, int numSamples)
     {
+        auto numChannels = buffer.getNumChannels();
+        auto block = SubBlockScheduler::getSlice(buffer, startSample, numSamples);
+
+        //a different delay store can't be allocated on the audio thread, so keep using the
+        //current one and crossfade over when the background thread has built the new one
+        auto requested = getRequestedStorage();
+
+        if (requested != lastRequest)
+        {
+            lastRequest = requested;
+            storeBuilder.request(getStoreSpec(requested, getSampleRate()));
+        }
+
+        swapInReadyStore();
+
+        //the reverb doesn't use the delay store at all
+        if (paramValues.getChoice<DelayMode>(Param::Mode) == DelayMode::Reverb)
+        {
+            updateReverb();
+            reverb.process(block, juce::jmin(getTotalNumInputChannels(), numChannels), paramValues.get(Param::FdnMix));
+            return;
+        }
+
+        //delay time is the same for every channel (and both stores while they crossfade), so work
+        //it out once. the fading store might be shorter, so it has to fit in that too
+        auto lineSize = delayStore->getNumSamples();
+
+        if (fadingStore != nullptr)
+            lineSize = juce::jmin(lineSize, fadingStore->getNumSamples());
+
+        //the oversampler in the feedback path makes the loop longer, so single mode reads that
+        //much sooner to keep the repeats on time. multi-tap and granular outputs don't go through it
+        auto mode = paramValues.getChoice<DelayMode>(Param::Mode);
+        auto factor = paramValues.getChoice<FeedbackSaturation::Factor>(Param::OsFactor);
+        auto latency = mode == DelayMode::Single ? delayStore->feedbackPaths[0].getLatency(factor) : 0;
+
+        updateDelayTimes(lineSize, delayStore->choice.storage == DelayStorage::Disk, latency, numSamples);
+
+        //feedback
+        //use setTargetValue to assign value to the smoother, then it fills in a gain for every
+        //sample of the block. once it's got there fill() leaves it alone and the one value does
+        feedbackSmoothed.setTargetValue(paramValues.get(Param::Feedback));
+        auto* feedbackRamp = feedbackSmoothed.fill(feedbackGains.data(), numSamples) ? feedbackGains.data() : nullptr;
+        auto feedback = feedbackSmoothed.getCurrentValue();
+
+        if (fadingStore == nullptr)
+        {
+            processStore(*delayStore, block, feedbackRamp, feedback);
+            return;
+        }
+
+        //the old store keeps playing, from its own copy of the input, while the output fades over.
+        //both have the dry signal in them and the gains add up to one, so that stays level
+        juce::AudioBuffer<float> fadeBlock(crossfadeBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            fadeBlock.copyFrom(channel, 0, block, channel, 0, numSamples);
+
+        processStore(*fadingStore, fadeBlock, feedbackRamp, feedback);
+        processStore(*delayStore, block, feedbackRamp, feedback);
+
+        auto startGain = (float) crossfadeRemaining / (float) crossfadeLength;
+        crossfadeRemaining = juce::jmax(0, crossfadeRemaining - numSamples);
+        auto endGain = (float) crossfadeRemaining / (float) crossfadeLength;
+
+        block.applyGainRamp(0, numSamples, 1.0f - startGain, 1.0f - endGain);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            block.addFromWithRamp(channel, 0, fadeBlock.getReadPointer(channel), numSamples, startGain, endGain);
+
+        //the old store gets freed on the background thread
+        if (crossfadeRemaining == 0)
+            storeBuilder.retire(std::move(fadingStore));
+    });
+}
 
-        //copy inpout signal to delay buffer
-        fillBuffer(buffer, channel);
-        //read from the past in the delay buffer
-        readFromBuffer(buffer, delayBuffer, channel);
-        //copy delayed signal to delay buffer again to create feedback loop
-        fillBuffer(buffer, channel);
-        
+void DelayTutorialAudioProcessor::processStore(DelayStore& store, juce::AudioBuffer<float>& buffer, const float* feedbackRamp, float feedback)
+{
+    switch (store.choice.format)
+    {
+        case DelaySampleFormat::Float16:    processDelay(store, store.float16Buffer, buffer, feedbackRamp, feedback); break;
+        case DelaySampleFormat::Int16:      processDelay(store, store.int16Buffer, buffer, feedbackRamp, feedback); break;
+        case DelaySampleFormat::BlockFloat: processDelay(store, store.blockFloatBuffer, buffer, feedbackRamp, feedback); break;
+        case DelaySampleFormat::Float32:
+        default:                            processDelay(store, store.buffer, buffer, feedbackRamp, feedback); break;
     }
+}
 
-    updateBufferPosition(buffer, delayBuffer);
+void DelayTutorialAudioProcessor::updateDelayTimes(int lineSize, bool onDisk, int latency, int numSamples)
+{
+    //keep the read point far enough from the write point for the 4 point lagrange read.
+    //at least 2 samples (after the latency comes off) so a tile always has something written before it reads it
+    auto minDelay = (float) (2 + latency);
+    auto maxDelay = (float) (lineSize - 4);
+
+    if (onDisk)
+    {
+        //minutes of delay is more samples than a float can count exactly, so disk mode
+        //reads whole samples at a fixed delay. changing it jumps, like a looper
+        auto longDelay = paramValues.get(Param::LongDelay) * getSampleRate();
+        auto delayInt = (int) juce::jlimit((double) minDelay, (double) maxDelay, longDelay) - latency;
+
+        std::fill(delayTimes.begin(), delayTimes.begin() + numSamples, (float) delayInt);
+        std::fill(delayInts.begin(), delayInts.begin() + numSamples, delayInt);
+        std::fill(delayFracs.begin(), delayFracs.begin() + numSamples, 0.0f);
+        delayIsConstant = true;
+        return;
+    }
+
+    auto delayTime = paramValues.get(Param::DelayMs);
+    delayTimeSmoothed.setTargetValue(juce::jlimit(minDelay, maxDelay, delayTime));
+
+    delayIsConstant = ! delayTimeSmoothed.fill(delayTimes.data(), numSamples);
+
+    if (delayIsConstant)
+        std::fill(delayTimes.begin(), delayTimes.begin() + numSamples, delayTimeSmoothed.getCurrentValue());
+
+    juce::FloatVectorOperations::add(delayTimes.data(), (float) -latency, numSamples);
+
+    DelayKernels::splitDelayTimes(delayTimes.data(), delayInts.data(), delayFracs.data(), numSamples);
 }
 
-void DelayTutorialAudioProcessor::fillBuffer(juce::AudioBuffer<float>& buffer, int channel)
+template <typename RingBuffer>
+void DelayTutorialAudioProcessor::processDelay(DelayStore& store, RingBuffer& line, juce::AudioBuffer<float>& buffer, const float* feedbackRamp, float feedback)
 {
+    auto numSamples = buffer.getNumSamples();
+    auto numChannels = juce::jmin(getTotalNumInputChannels(), line.getNumChannels());
+    auto writePosition = store.writePosition;
+    auto& multiTap = store.multiTap;
+
+    auto interpolation = paramValues.getChoice<DelayInterpolation>(Param::Interp);
+    auto mode = paramValues.getChoice<DelayMode>(Param::Mode);
+    auto factor = paramValues.getChoice<FeedbackSaturation::Factor>(Param::OsFactor);
+    for (int part = 0; part < store.numParts; ++part)
+        store.feedbackPaths[(size_t) part].setParameters(paramValues.get(Param::FbDrive), paramValues.get(Param::FbTone));
+
+    if (mode == DelayMode::Granular)
+    {
+        //the history just records the input, the grains play out of it
+        for (int channel = 0; channel < numChannels; ++channel)
+            line.write(channel, writePosition, buffer.getReadPointer(channel), numSamples);
 
-    //auto* channelData = buffer.getWritePointer(channel);
+        store.granular.process(line, writePosition, line.getNumSamples(), buffer, numChannels,
+                               getGrainSettings(delayTimes[0]), paramValues.get(Param::GrainMix));
 
-    auto bufferSize = buffer.getNumSamples();
-    auto delayBufferSize = delayBuffer.getNumSamples();
+        updateBufferPosition(store, line.getMask(), buffer);
+        return;
+    }
+
+    if (mode == DelayMode::MultiTap)
+        updateTaps(store, delayTimes[0]);
 
-    //check to see if main buffer copies to delay buffer without needing to wrap
-    if (delayBufferSize > bufferSize + writePosition)
+    if (line.isOnDisk())
     {
-        //copy main buffer contents to delay buffer
-        delayBuffer.copyFrom(channel, writePosition, buffer.getWritePointer(channel), bufferSize);
+        //count it if this block reads something the prefetcher didn't get to, then
+        //tell it where the next block will be
+        auto readPosition = writePosition - delayInts[0];
+        store.prefetcher.checkWindow(readPosition, numSamples);
+        store.prefetcher.setPositions(readPosition + numSamples, writePosition + numSamples);
+
+        diskUnderruns = store.prefetcher.getNumUnderruns();
+        diskPrefetchMs = store.prefetcher.getLastPrefetchMs();
     }
-    //if no
-    else
+
+    //go through the block a tile at a time. each tile reads the delayed signal, adds it to the input and
+    //writes the result back into the delay buffer while it's all still in cache, instead of walking the
+    //whole block three times. a tile is never longer than the shortest delay inside it, so it never reads
+    //samples it's about to write, and short delays still feed back sample accurately
+    //wide layouts go a part of the channels at a time. every channel has its own history, taps and
+    //filter states, and every part works out the same tiles, so the parts never touch each other's
+    //data and can run on the workers at the same time
+    //getWritePointer() marks the buffer as not clear, so the parts get the pointers up front instead
+    auto* const* outputChannels = buffer.getArrayOfWritePointers();
+    auto* const* delayedChannels = delayedTile.getArrayOfWritePointers();
+    auto* const* feedbackChannels = feedbackTile.getArrayOfWritePointers();
+
+    auto processPart = [&] (int part)
     {
-        //determine how much space is left at the end of the delay buffer
-        auto numSamplesToEnd = delayBufferSize - writePosition;
+        auto firstChannel = juce::jmin(numChannels, store.getPartStart(part));
+        auto endChannel = juce::jmin(numChannels, store.getPartEnd(part));
+
+        if (firstChannel >= endChannel)
+            return;
+
+        for (int tileStart = 0; tileStart < numSamples;)
+        {
+            auto maxLength = juce::jmin(tileSize, numSamples - tileStart);
+            auto shortestDelay = (int) juce::FloatVectorOperations::findMinimum(delayTimes.data() + tileStart, maxLength);
+
+            //the taps read whole samples, so the shortest tap limits the tile the same way
+            if (mode == DelayMode::MultiTap)
+                shortestDelay = juce::jmin(shortestDelay, multiTap.getShortestDelay() + 1);
+
+            auto tileLength = juce::jlimit(1, maxLength, shortestDelay - 1);
+            auto position = writePosition + tileStart;
+
+            //read every channel first, so the feedback path can do them all at once
+            for (int channel = firstChannel; channel < endChannel; ++channel)
+            {
+                auto* delayed = delayedChannels[channel];
+
+                if (mode == DelayMode::MultiTap)
+                {
+                    multiTap.process(line, channel, position, delayed, tileLength);
+                    continue;
+                }
+
+                //a delay that isn't moving reads straight along the buffer instead of through a
+                //wrapped index for every sample, which vectorizes (packed formats decode per sample anyway)
+                if constexpr (std::is_same_v<RingBuffer, MirroredRingBuffer>)
+                {
+                    if (delayIsConstant && interpolation == DelayInterpolation::Linear)
+                    {
+                        DelayKernels::readLinearConstant(line.getReadPointer(channel, position - delayInts[0] - 1),
+                                                         delayFracs[0], delayed, tileLength);
+                        continue;
+                    }
+                }
+
+                //read from the past in the delay buffer, in between samples if needed
+                DelayKernels::readInterpolated(interpolation, line.getReader(channel), position,
+                                               delayInts.data() + tileStart, delayFracs.data() + tileStart,
+                                               delayed, tileLength, store.thiranStates[(size_t) channel]);
+            }
+
+            //delay signal is a little quieter than main signal, and gets saturated and darker on each trip round
+            for (int channel = firstChannel; channel < endChannel; ++channel)
+            {
+                if (feedbackRamp != nullptr)
+                    juce::FloatVectorOperations::multiply(feedbackChannels[channel], delayedChannels[channel], feedbackRamp + tileStart, tileLength);
+                else
+                    juce::FloatVectorOperations::multiply(feedbackChannels[channel], delayedChannels[channel], feedback, tileLength);
+            }
+
+            juce::dsp::AudioBlock<float> feedbackBlock(feedbackChannels + firstChannel,
+                                                       (size_t) (endChannel - firstChannel), (size_t) tileLength);
+            store.feedbackPaths[(size_t) part].process(feedbackBlock, factor);
+
+            for (int channel = firstChannel; channel < endChannel; ++channel)
+            {
+                auto* channelData = outputChannels[channel] + tileStart;
+                auto* feedbackData = feedbackChannels[channel];
+
+                if (mode == DelayMode::MultiTap)
+                {
+                    //taps play at their own level, feedback only sets how much of them goes back round
+                    juce::FloatVectorOperations::add(feedbackData, channelData, tileLength);
+                    line.write(channel, position, feedbackData, tileLength);
+
+                    juce::FloatVectorOperations::add(channelData, delayedChannels[channel], tileLength);
+                    continue;
+                }
+
+                juce::FloatVectorOperations::add(channelData, feedbackData, tileLength);
+
+                //input plus delayed signal goes back into the delay buffer to create the feedback loop
+                line.write(channel, position, channelData, tileLength);
+            }
+
+            tileStart += tileLength;
+        }
+    };
+
+    if (store.numParts > 1 && numSamples >= minParallelSamples && paramValues.getBool(Param::Parallel))
+        workers.run(store.numParts, processPart);
+    else
+        for (int part = 0; part < store.numParts; ++part)
+            processPart(part);
+
+    updateBufferPosition(store, line.getMask(), buffer);
+}
 
-        //copy that amount of contents to end of delay buffer
-        delayBuffer.copyFrom(channel, writePosition, buffer.getWritePointer(channel), numSamplesToEnd);
+void DelayTutorialAudioProcessor::updateTaps(DelayStore& store, float delayTime)
+{
+    auto& tapLayout = store.tapLayout;
+    auto& multiTap = store.multiTap;
 
-        //calculate how much content is remaining to copy
-        auto numSamplesAtStart = bufferSize - numSamplesToEnd;
+    std::array<float, 5> layout{ std::floor(delayTime),
+                                 paramValues.get(Param::Taps),
+                                 paramValues.get(Param::TapDecay),
+                                 paramValues.get(Param::TapWidth),
+                                 paramValues.get(Param::TapTone) };
 
-        //copy remaining amount to beginning of delay buffer
-        delayBuffer.copyFrom(channel, 0, buffer.getWritePointer(channel, numSamplesToEnd), numSamplesAtStart);
+    if (layout == tapLayout)
+        return;
+
+    tapLayout = layout;
+
+    auto numTaps = juce::jlimit(1, MultiTapDelay::maxTaps, (int) layout[1]);
+    auto decay = layout[2];
+    auto width = layout[3];
+    auto tone = layout[4];
+
+    //taps are spread evenly up to the delay time, each one quieter, darker and panned
+    //to the other side than the one before it
+    multiTap.clearTaps();
+
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        auto position = (float) (tap + 1) / (float) numTaps;
+        auto pan = (tap % 2 == 0 ? -width : width);
+        auto cutoff = 20000.0f * std::pow(tone / 20000.0f, position);
+
+        multiTap.setTap(tap, layout[0] * position, std::pow(decay, (float) tap), pan, cutoff);
     }
 }
 
-//read from delay buffer to main buffer to play delayed signal
-void DelayTutorialAudioProcessor::readFromBuffer(juce::AudioBuffer<float>& buffer, juce::AudioBuffer<float>& delayBuffer, int channel)
+double DelayTutorialAudioProcessor::getTailSamples(double sampleRate) const
 {
+    auto mode = paramValues.getChoice<DelayMode>(Param::Mode);
 
-    auto bufferSize = buffer.getNumSamples();
-    auto delayBufferSize = delayBuffer.getNumSamples();
-  
+    //decay time is down to -60 dB, silence is twice as far down
+    if (mode == DelayMode::Reverb)
+        return 2.0 * paramValues.get(Param::FdnDecay) * sampleRate;
 
-    //feedback
-    auto* gain = params.getRawParameterValue("FEEDBACK");
+    //DELAYMS counts samples
+    auto delay = paramValues.getChoice<DelayStorage>(Param::Storage) == DelayStorage::Disk
+               ? paramValues.get(Param::LongDelay) * sampleRate
+               : (double) paramValues.get(Param::DelayMs);
 
-    //use setTargetValue to assign value to LinearSmoothedValue
-    //using ->load() gets float value from parameter
-    g.setTargetValue(gain->load());
+    //grains don't feed back, the last one can start from the furthest back and play for its length
+    if (mode == DelayMode::Granular)
+        return delay + paramValues.get(Param::GrainSize) * 0.001 * sampleRate;
 
-    //use getNextValue() when LinearSmoothedValue is inside a function to retrieve actual float value
-    auto feedback = g.getNextValue();
+    //gain once round the loop. multi-tap sends the sum of all its taps back, and the taps
+    //get decay^tap quieter each. saturation and the tone filter only ever make it quieter
+    auto loopGain = (double) paramValues.get(Param::Feedback);
 
-    //read position is 1 sec in the past of write position (current position)
-    // !!changing readPosition changes delay amount!!
-    auto* delayMs = params.getRawParameterValue("DELAYMS");
-    auto delayTime = delayMs->load();
-    auto readPosition = writePosition - delayTime;
+    if (mode == DelayMode::MultiTap)
+    {
+        auto numTaps = paramValues.getInt(Param::Taps);
+        auto decay = (double) paramValues.get(Param::TapDecay);
+        loopGain *= decay < 1.0 ? (1.0 - std::pow(decay, numTaps)) / (1.0 - decay) : (double) numTaps;
+    }
+
+    //it never dies away
+    if (loopGain >= 1.0)
+        return std::numeric_limits<double>::infinity();
+
+    //one trip to get out, then however many it takes to fall below silence
+    auto trips = 1.0;
 
+    if (loopGain > 0.0)
+        trips += std::ceil(std::log((double) silenceLevel) / std::log(loopGain));
+
+    return delay * trips;
+}
+
+bool DelayTutorialAudioProcessor::isIdle(const juce::AudioBuffer<float>& buffer)
+{
+    auto numSamples = buffer.getNumSamples();
+    auto silent = true;
 
-    //if read position is < 0, pull from END indices of delay buffer
-    if (readPosition < 0)
-        //+= because adding a negative number
-        readPosition += delayBufferSize;
+    for (int channel = 0; channel < getTotalNumInputChannels() && silent; ++channel)
+        silent = buffer.getMagnitude(channel, 0, numSamples) < silenceLevel;
 
-    //easy situation: has room to write bufferSize amount of data to buffer (won't spill over to beginning)
-    if (readPosition + bufferSize < delayBufferSize)
+    if (! silent)
     {
-        //addFrom() adds data to main buffer without overwriting contents
-        //addFromWithRamp() because delay signal is a little quieter than main signal
-        buffer.addFromWithRamp(channel, 0, delayBuffer.getReadPointer(channel, readPosition), bufferSize, feedback, feedback);
+        //input's back. the history was zeroed a piece at a time while it was idle, and whatever
+        //hasn't been yet carries on that way (the newest part, which the delay reads first, went first)
+        if (idle)
+        {
+            for (auto* store : { delayStore.get(), fadingStore.get() })
+                if (store != nullptr)
+                    store->resetState();
+
+            reverb.reset();
+        }
+
+        silentSamples = 0;
+        idle = false;
+        clearStaleHistory();
+        return false;
     }
-    //if read position is towards end of delay buffer and doesn't have bufferSize amount of data to copy over to the main buffer.
-    //copy some to end of buffer, then some to beginning of buffer
-    else
+
+    silentSamples += numSamples;
+
+    //a swap has to finish first, and disk mode never stops (clearing it would load the whole file)
+    if (! idle && fadingStore == nullptr && nextStore == nullptr && delayStore->choice.storage != DelayStorage::Disk)
     {
-        auto numSamplesToEnd = delayBufferSize - readPosition;
-        buffer.addFromWithRamp(channel, 0, delayBuffer.getReadPointer(channel, readPosition), numSamplesToEnd, feedback, feedback);
+        idle = (double) silentSamples >= getTailSamples(getSampleRate());
 
-        auto numSamplesAtStart = bufferSize - numSamplesToEnd;
-        //destStartSample is not 0 because we've already added numSamplesToEnd of samples to main buffer
-        //sampleIndex for getReadPointer() is 0 because we've wrapped back to the beginning of the delayu buffer to grab samples from
-        buffer.addFromWithRamp(channel, numSamplesToEnd, delayBuffer.getReadPointer(channel, 0), numSamplesAtStart, feedback, feedback);
+        if (idle)
+            delayStore->startClear();
     }
+
+    clearStaleHistory();
+    return idle;
 }
 
-void DelayTutorialAudioProcessor::updateBufferPosition(juce::AudioBuffer<float>& buffer, juce::AudioBuffer<float>& delayBuffer)
+void DelayTutorialAudioProcessor::clearStaleHistory()
+{
+    for (auto* store : { delayStore.get(), fadingStore.get() })
+        if (store != nullptr)
+            store->clearSome(clearSamplesPerBlock / juce::jmax(1, store->spec.numChannels));
+}
+
+void DelayTutorialAudioProcessor::updateReverb()
+{
+    //FDNLINES is a choice of 4, 8 or 16
+    auto numLines = 4 << paramValues.getInt(Param::FdnLines);
+
+    reverb.setParameters(numLines,
+                         paramValues.getChoice<FeedbackDelayNetwork::Matrix>(Param::FdnMatrix),
+                         paramValues.get(Param::FdnSize),
+                         paramValues.get(Param::FdnDecay),
+                         paramValues.get(Param::FdnDamp));
+}
+
+GranularEngine::Settings DelayTutorialAudioProcessor::getGrainSettings(float delayTime) const
+{
+    GranularEngine::Settings settings;
+    settings.density = paramValues.get(Param::GrainDensity);
+    settings.lengthSamples = paramValues.get(Param::GrainSize) * 0.001f * (float) getSampleRate();
+    settings.delaySamples = delayTime;
+    settings.spread = paramValues.get(Param::GrainSpread);
+    settings.pitchSemitones = paramValues.get(Param::GrainPitch);
+    settings.pitchRandom = paramValues.get(Param::GrainPitchRandom);
+    settings.panWidth = paramValues.get(Param::GrainPan);
+    settings.window = paramValues.getChoice<GranularEngine::Window>(Param::GrainWindow);
+    return settings;
+}
+
+void DelayTutorialAudioProcessor::updateBufferPosition(DelayStore& store, int lineMask, juce::AudioBuffer<float>& buffer)
 {
     auto bufferSize = buffer.getNumSamples();
-    auto delayBufferSize = delayBuffer.getNumSamples();
 
-    writePosition += bufferSize;
-    writePosition %= delayBufferSize;
+    //delay buffer size is a power of two, so wrapping is just a mask
+    store.writePosition = (store.writePosition + bufferSize) & lineMask;
+
+    //that's written over the oldest of any history still waiting to be zeroed
+    store.staleSamples = juce::jmax(0, store.staleSamples - bufferSize);
 }
 
 //==============================================================================
@@ -282,15 +854,3 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new DelayTutorialAudioProcessor();
 }
-
-//function to create AudioProcessorValueTreeState parameters
-juce::AudioProcessorValueTreeState::ParameterLayout DelayTutorialAudioProcessor::createParameters()
-{
-    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
-
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("DELAYMS", "Delay ms", 0.0f, 96000.0f, 0.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("FEEDBACK", "Feedback", 0.0f, 1.0f, 0.0f));
-
-    return { params.begin(), params.end() };
-}
-
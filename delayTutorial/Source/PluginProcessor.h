@@ -9,6 +9,20 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../shared/ChannelLayouts.h"
+#include "../../shared/ChannelWorkers.h"
+#include "../../shared/ParameterTable.h"
+#include "../../shared/Smoothing.h"
+#include "../../shared/SubBlockScheduler.h"
+#include "DelayInterpolation.h"
+#include "MirroredRingBuffer.h"
+#include "PackedRingBuffer.h"
+#include "MultiTapDelay.h"
+#include "FeedbackDelayNetwork.h"
+#include "GranularEngine.h"
+#include "FeedbackSaturation.h"
+#include "DelayPrefetcher.h"
+#include "BackgroundBuilder.h"
 
 //==============================================================================
 /**
@@ -56,25 +70,391 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //disk mode stats, safe to call from any thread
+    int getDiskUnderruns() const noexcept { return diskUnderruns.load(); }
+    double getDiskPrefetchMs() const noexcept { return diskPrefetchMs.load(); }
+
 private:
-    //circular buffer function
-    void fillBuffer(juce::AudioBuffer<float>& buffer, int channel);
-    //function to read in delayed signal
-    void readFromBuffer(juce::AudioBuffer<float>& buffer, juce::AudioBuffer<float>& delayBuffer, int channel);
+    //select delay mode
+    enum class DelayMode
+    {
+        Single,
+        MultiTap,
+        Reverb,
+        Granular,
+    };
+
+    //where the delay history is kept
+    enum class DelayStorage
+    {
+        Memory,
+        Disk,
+    };
+
+    //where and how the delay history is kept
+    struct StorageChoice
+    {
+        DelayStorage storage;
+        DelaySampleFormat format;
+
+        bool operator== (const StorageChoice& other) const noexcept { return storage == other.storage && format == other.format; }
+        bool operator!= (const StorageChoice& other) const noexcept { return ! operator== (other); }
+    };
+
+    //what a delay store has to be built for
+    struct StoreSpec
+    {
+        StorageChoice choice;
+        int numChannels;
+        //samples of history for the longest delay the parameters allow
+        int capacity;
+        //longest block that gets written in one go
+        int windowSize;
+        double sampleRate;
+    };
+
+    //one delay history and everything that goes with it. processBlock owns the one in use,
+    //new ones get built on a background thread and crossfaded in
+    struct DelayStore
+    {
+        //true if this store can be used for needed without growing
+        bool fits(const StoreSpec& needed) const noexcept
+        {
+            return spec.choice == needed.choice && spec.numChannels == needed.numChannels
+                && spec.capacity >= needed.capacity && spec.windowSize >= needed.windowSize;
+        }
+
+        //start zeroing the history, clearSome() does it a piece at a time so it never holds up one
+        //block. not for disk, that would load the whole file on the audio thread
+        void startClear() noexcept
+        {
+            if (choice.storage == DelayStorage::Disk)
+                return;
+
+            staleEnd = writePosition;
+            staleSamples = getNumSamples();
+        }
+
+        //zero up to maxSamples more of the history startClear() left, newest first
+        void clearSome(int maxSamples) noexcept
+        {
+            auto numSamples = juce::jmin(maxSamples, staleSamples);
+
+            if (numSamples <= 0)
+                return;
+
+            staleEnd = (staleEnd - numSamples) & (getNumSamples() - 1);
+            staleSamples -= numSamples;
+
+            switch (choice.format)
+            {
+                case DelaySampleFormat::Float16:    float16Buffer.clear(staleEnd, numSamples); break;
+                case DelaySampleFormat::Int16:      int16Buffer.clear(staleEnd, numSamples); break;
+                case DelaySampleFormat::BlockFloat: blockFloatBuffer.clear(staleEnd, numSamples); break;
+                case DelaySampleFormat::Float32:
+                default:                            buffer.clear(staleEnd, numSamples); break;
+            }
+        }
+
+        //silence everything else that remembers the history, it's all small enough to do at once
+        void resetState() noexcept
+        {
+            std::fill(thiranStates.begin(), thiranStates.end(), 0.0f);
+            multiTap.reset();
+            granular.reset();
+
+            for (auto& feedbackPath : feedbackPaths)
+                feedbackPath.reset();
+        }
+
+        //split the channels into parts and set up a feedback path for each one
+        void prepareParts(double sampleRate)
+        {
+            numParts = spec.numChannels >= minParallelChannels
+                     ? juce::jmin(ChannelWorkers::maxTasks, (spec.numChannels + channelsPerPart - 1) / channelsPerPart)
+                     : 1;
+
+            for (int part = 0; part < numParts; ++part)
+                feedbackPaths[(size_t) part].prepare(sampleRate, getPartEnd(part) - getPartStart(part), tileSize);
+        }
+
+        //first channel of part, and one past its last
+        int getPartStart(int part) const noexcept { return juce::jmin(spec.numChannels, part * getChannelsPerPart()); }
+        int getPartEnd(int part) const noexcept { return juce::jmin(spec.numChannels, (part + 1) * getChannelsPerPart()); }
+        int getChannelsPerPart() const noexcept { return (spec.numChannels + numParts - 1) / numParts; }
+
+        //call function with whichever of the buffers holds the history
+        template <typename Function>
+        void withLine(Function&& function)
+        {
+            switch (choice.format)
+            {
+                case DelaySampleFormat::Float16:    function(float16Buffer); break;
+                case DelaySampleFormat::Int16:      function(int16Buffer); break;
+                case DelaySampleFormat::BlockFloat: function(blockFloatBuffer); break;
+                case DelaySampleFormat::Float32:
+                default:                            function(buffer); break;
+            }
+        }
+
+        int getNumSamples() const noexcept
+        {
+            switch (choice.format)
+            {
+                case DelaySampleFormat::Float16:    return float16Buffer.getNumSamples();
+                case DelaySampleFormat::Int16:      return int16Buffer.getNumSamples();
+                case DelaySampleFormat::BlockFloat: return blockFloatBuffer.getNumSamples();
+                case DelaySampleFormat::Float32:
+                default:                            return buffer.getNumSamples();
+            }
+        }
+
+        StoreSpec spec;
+        //what actually got built, disk falls back to float32 in memory if the file can't be mapped
+        StorageChoice choice;
+
+        //float32 history, power of two long and mirrored so blocks never have to be split.
+        //in memory, or in a memory mapped file for delays of several minutes
+        MirroredRingBuffer buffer;
+        //keeps the part of buffer that's about to be read loaded in memory (disk only)
+        DelayPrefetcher prefetcher{ buffer };
+        //smaller sample formats for the in-memory history. only one buffer per store is allocated
+        PackedRingBuffer<DelayCodecs::Float16> float16Buffer;
+        PackedRingBuffer<DelayCodecs::Int16> int16Buffer;
+        PackedRingBuffer<DelayCodecs::BlockFloat> blockFloatBuffer;
+
+        int writePosition{ 0 };
+        //history that still has to be zeroed, the staleSamples before staleEnd. clearSome() takes it
+        //from the top and every block written takes it from the bottom (at writePosition)
+        int staleEnd{ 0 };
+        int staleSamples{ 0 };
+        //one allpass state per channel for thiran interpolation
+        std::vector<float> thiranStates;
+
+        //all taps read from the one buffer, so rhythmic presets don't need a delay buffer per tap
+        MultiTapDelay multiTap;
+        //tap parameters the taps were last laid out with (delay, count, decay, width, tone)
+        std::array<float, 5> tapLayout{};
+
+        //grains read from the same history
+        GranularEngine granular;
+
+        //saturation and tone filter on what goes back round the loop. wide layouts get one for each
+        //part of the channels, so the parts can run at the same time
+        std::array<FeedbackSaturation, ChannelWorkers::maxTasks> feedbackPaths;
+        int numParts{ 1 };
+    };
+
+    //read the delayed signal, mix in feedback and write the delay buffer in one pass.
+    //RingBuffer is whichever of store's buffers is in use (MirroredRingBuffer or PackedRingBuffer).
+    //feedbackRamp has the feedback gain for every sample while it's changing, and is nullptr
+    //once it's settled on feedback
+    template <typename RingBuffer>
+    void processDelay(DelayStore& store, RingBuffer& line, juce::AudioBuffer<float>& buffer, const float* feedbackRamp, float feedback);
+    //processDelay with whichever buffer store uses
+    void processStore(DelayStore& store, juce::AudioBuffer<float>& buffer, const float* feedbackRamp, float feedback);
     //function to update buffer writePosition 
-    void updateBufferPosition(juce::AudioBuffer<float>& buffer, juce::AudioBuffer<float>& delayBuffer);
+    void updateBufferPosition(DelayStore& store, int lineMask, juce::AudioBuffer<float>& buffer);
+    //fill delayTimes with one smoothed delay time per sample. latency is taken off the read
+    //position, to make up for what the feedback path adds
+    void updateDelayTimes(int lineSize, bool onDisk, int latency, int numSamples);
+    //lay the taps out again if any of the tap parameters have changed
+    void updateTaps(DelayStore& store, float delayTime);
+    //storage the parameters are asking for
+    StorageChoice getRequestedStorage() const;
+    //what a store for choice needs at sampleRate. doesn't allocate, so it's fine on the audio thread
+    StoreSpec getStoreSpec(StorageChoice choice, double sampleRate) const;
+    //samples of history needed for the longest delay the parameters allow
+    int getCapacity(DelayStorage storage, double sampleRate) const;
+    //allocate a delay store (never on the audio thread)
+    std::unique_ptr<DelayStore> createStore(const StoreSpec& spec);
+    //start using a store the background thread has finished, crossfading from the old one once
+    //the old one's history has been carried over into it
+    void swapInReadyStore();
+    //copy up to maxSamples more of delayStore's history into nextStore, oldest first. returns true
+    //once it's caught up with delayStore's write position
+    bool seedNextStore(int maxSamples);
+    //copy numSamples of history from position on out of one buffer and into the other, at the same positions
+    template <typename FromLine, typename ToLine>
+    void copyHistory(FromLine& from, ToLine& to, int position, int numSamples);
+    //samples it takes for the output to fall below silenceLevel once the input stops
+    double getTailSamples(double sampleRate) const;
+    //keeps track of how long the input has been silent. returns true once the tail has died
+    //away too, then the block can pass straight through. the history gets zeroed while it's idle
+    bool isIdle(const juce::AudioBuffer<float>& buffer);
+    //zero some more of any history that's been left stale, a bounded amount per block
+    void clearStaleHistory();
+    //set the reverb up from its parameters
+    void updateReverb();
+    //grain parameters, delayTime is where the grains read from
+    GranularEngine::Settings getGrainSettings(float delayTime) const;
+
+    //delay history in use, and the one being faded out after a swap
+    std::unique_ptr<DelayStore> delayStore;
+    std::unique_ptr<DelayStore> fadingStore;
+    //built and waiting to be swapped in while delayStore's history is copied into it. seedSamples
+    //of history before delayStore's write position still have to go across, seedPosition is where
+    //that write position was the last time a piece went
+    std::unique_ptr<DelayStore> nextStore;
+    int seedSamples{ 0 };
+    int seedPosition{ 0 };
+    //storage processBlock last asked for, so it only asks once per change
+    StorageChoice lastRequest{ DelayStorage::Memory, DelaySampleFormat::Float32 };
+
+    //fading store plays into this copy of the input while it fades out
+    juce::AudioBuffer<float> crossfadeBuffer;
+    int crossfadeLength{ 1 };
+    int crossfadeRemaining{ 0 };
+
+    //longest delay in disk mode
+    static constexpr double maxDiskDelaySeconds = 300.0;
+
+    //disk mode stats, copied out of the store in use
+    std::atomic<int> diskUnderruns{ 0 };
+    std::atomic<double> diskPrefetchMs{ 0.0 };
 
-    juce::AudioBuffer<float> delayBuffer;
-    int writePosition{ 0 };
+    //anything quieter than this (-120 dB) counts as silence
+    static constexpr float silenceLevel = 1.0e-6f;
+    //most history zeroed in one block, counting every channel (128 kB of float32)
+    static constexpr int clearSamplesPerBlock = 32768;
+    //most history carried over into nextStore in one slice, counting every channel
+    static constexpr int seedSamplesPerSlice = 4096;
+    //samples of silent input in a row, and whether processing is being skipped
+    juce::int64 silentSamples{ 0 };
+    bool idle{ false };
+
+    //reverb mode, a feedback delay network with its own delay lines
+    FeedbackDelayNetwork reverb;
+
+    //layouts with this many channels get split into parts that can run at the same time
+    static constexpr int minParallelChannels = 16;
+    static constexpr int channelsPerPart = 4;
+    //slices shorter than this (cut short by MIDI) aren't worth handing to the workers
+    static constexpr int minParallelSamples = 16;
+    //only started for wide layouts
+    ChannelWorkers workers;
+
+    //largest block we process in one go, bigger host blocks get split up
+    int maxBlockSize{ 0 };
+    //processDelay works through a block in tiles this long (or shorter) so they stay in cache
+    static constexpr int tileSize = 64;
+    //splits processBlock into slices no longer than a tile, parameters are read once per slice
+    SubBlockScheduler scheduler;
+
+    //per-sample delay times, split into whole and fractional parts for the read kernels
+    std::vector<float> delayTimes;
+    std::vector<int> delayInts;
+    std::vector<float> delayFracs;
+    //true when the delay time isn't moving, so every sample of the slice has the same one
+    bool delayIsConstant{ true };
+    //per-sample feedback gains, only filled in while the feedback is moving
+    std::vector<float> feedbackGains;
+    //delayed signal for one tile of every channel, read out of the delay buffer before it gets mixed in
+    juce::AudioBuffer<float> delayedTile;
+    //what goes back into the delay buffer for one tile of every channel
+    juce::AudioBuffer<float> feedbackTile;
+
+    //every parameter, order has to match parameterTable
+    enum class Param
+    {
+        DelayMs,
+        Feedback,
+        Interp,
+        Mode,
+        Taps,
+        TapDecay,
+        TapWidth,
+        TapTone,
+        Storage,
+        LongDelay,
+        Format,
+        //reverb mode
+        FdnLines,
+        FdnMatrix,
+        FdnSize,
+        FdnDecay,
+        FdnDamp,
+        FdnMix,
+        //granular mode
+        GrainDensity,
+        GrainSize,
+        GrainSpread,
+        GrainPitch,
+        GrainPitchRandom,
+        GrainPan,
+        GrainWindow,
+        GrainMix,
+        //feedback path
+        OsFactor,
+        FbDrive,
+        FbTone,
+        Parallel,
+    };
+
+    //choice names, order has to match the enum each one gets read as
+    static constexpr const char* interpolationChoices[]{ "Linear", "Lagrange", "Thiran" };
+    static constexpr const char* modeChoices[]{ "Single", "Multi-Tap", "Reverb", "Granular" };
+    static constexpr const char* storageChoices[]{ "Memory", "Disk" };
+    //only used for memory storage
+    static constexpr const char* formatChoices[]{ "Float32", "Float16", "Int16", "Block Float" };
+    //4 << index lines
+    static constexpr const char* fdnLinesChoices[]{ "4", "8", "16" };
+    static constexpr const char* fdnMatrixChoices[]{ "Hadamard", "Householder" };
+    static constexpr const char* grainWindowChoices[]{ "Hann", "Gaussian", "Trapezoid" };
+    static constexpr const char* osFactorChoices[]{ "Off", "2x", "4x", "8x" };
+
+    //IDs, names, ranges and defaults of every parameter. the layout and the handles are both made from this
+    static constexpr std::array<ParameterTable::Spec, 29> parameterTable{ {
+        ParameterTable::floatParameter(Param::DelayMs, "DELAYMS", "Delay ms", 0.0f, 96000.0f, 0.0f),
+        ParameterTable::floatParameter(Param::Feedback, "FEEDBACK", "Feedback", 0.0f, 1.0f, 0.0f),
+        ParameterTable::choiceParameter(Param::Interp, "INTERP", "Interpolation", interpolationChoices, 0),
+        ParameterTable::choiceParameter(Param::Mode, "MODE", "Mode", modeChoices, 0),
+        ParameterTable::intParameter(Param::Taps, "TAPS", "Taps", 1, MultiTapDelay::maxTaps, 4),
+        ParameterTable::floatParameter(Param::TapDecay, "TAPDECAY", "Tap Decay", 0.0f, 1.0f, 0.7f),
+        ParameterTable::floatParameter(Param::TapWidth, "TAPWIDTH", "Tap Width", 0.0f, 1.0f, 0.5f),
+        ParameterTable::floatParameter(Param::TapTone, "TAPTONE", "Tap Tone", 200.0f, 20000.0f, 8000.0f),
+        ParameterTable::choiceParameter(Param::Storage, "STORAGE", "Storage", storageChoices, 0),
+        ParameterTable::floatParameter(Param::LongDelay, "LONGDELAY", "Long Delay s", 0.1f, (float) maxDiskDelaySeconds, 10.0f),
+        ParameterTable::choiceParameter(Param::Format, "FORMAT", "Sample Format", formatChoices, 0),
+        ParameterTable::choiceParameter(Param::FdnLines, "FDNLINES", "Reverb Lines", fdnLinesChoices, 1),
+        ParameterTable::choiceParameter(Param::FdnMatrix, "FDNMATRIX", "Reverb Matrix", fdnMatrixChoices, 0),
+        ParameterTable::floatParameter(Param::FdnSize, "FDNSIZE", "Reverb Size", 0.25f, FeedbackDelayNetwork::maxSize, 1.0f),
+        ParameterTable::floatParameter(Param::FdnDecay, "FDNDECAY", "Reverb Decay s", 0.1f, 20.0f, 2.0f),
+        ParameterTable::floatParameter(Param::FdnDamp, "FDNDAMP", "Reverb Damping Hz", 500.0f, 20000.0f, 6000.0f),
+        ParameterTable::floatParameter(Param::FdnMix, "FDNMIX", "Reverb Mix", 0.0f, 1.0f, 0.3f),
+        ParameterTable::floatParameter(Param::GrainDensity, "GRAINDENSITY", "Grains per s", 1.0f, 500.0f, 40.0f),
+        ParameterTable::floatParameter(Param::GrainSize, "GRAINSIZE", "Grain Size ms", 10.0f, 500.0f, 80.0f),
+        ParameterTable::floatParameter(Param::GrainSpread, "GRAINSPREAD", "Grain Spread", 0.0f, 1.0f, 0.3f),
+        ParameterTable::floatParameter(Param::GrainPitch, "GRAINPITCH", "Grain Pitch st", -24.0f, 24.0f, 0.0f),
+        ParameterTable::floatParameter(Param::GrainPitchRandom, "GRAINPITCHRAND", "Grain Pitch Random st", 0.0f, 12.0f, 0.0f),
+        ParameterTable::floatParameter(Param::GrainPan, "GRAINPAN", "Grain Pan Width", 0.0f, 1.0f, 0.5f),
+        ParameterTable::choiceParameter(Param::GrainWindow, "GRAINWINDOW", "Grain Window", grainWindowChoices, 0),
+        ParameterTable::floatParameter(Param::GrainMix, "GRAINMIX", "Grain Mix", 0.0f, 1.0f, 0.5f),
+        ParameterTable::choiceParameter(Param::OsFactor, "OSFACTOR", "Feedback Oversampling", osFactorChoices, 1),
+        ParameterTable::floatParameter(Param::FbDrive, "FBDRIVE", "Feedback Drive dB", 0.0f, 24.0f, 0.0f),
+        ParameterTable::floatParameter(Param::FbTone, "FBTONE", "Feedback Tone Hz", 1000.0f, 20000.0f, 20000.0f),
+        //run wide layouts' channels on worker threads as well as the audio thread
+        ParameterTable::boolParameter(Param::Parallel, "PARALLEL", "Parallel Channels", false),
+    } };
+
+    static_assert(ParameterTable::isValid(parameterTable), "parameterTable is out of order, has a repeated ID or a default outside its range");
+
+    //range of a parameter, known at compile time
+    static constexpr const ParameterTable::Spec& getSpec(Param param) { return parameterTable[(size_t) param]; }
 
-    //set up parameters
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
     juce::AudioProcessorValueTreeState params;
-    std::atomic<float>* delayMsParam = nullptr;
-    std::atomic<float>* feedbackParam = nullptr;
+    //cached handle for every parameter, so the audio thread never looks one up by ID
+    ParameterTable::Handles<Param, parameterTable.size()> paramValues{ params, parameterTable };
+
+    //using smoothing on parameter values to prevent clicks and pops, feedback ramps per sample
+    Smoothing::Smoother<Smoothing::Method::Linear> feedbackSmoothed;
+    //delay time gets swept per sample so automating it doesn't zipper
+    Smoothing::Smoother<Smoothing::Method::Linear> delayTimeSmoothed;
 
-    //using smoothing on parameter values to prevent clicks and pops
-    juce::LinearSmoothedValue<float> g{ 0.0f };
+    //builds new delay stores when the storage or the sample rate needs a bigger one, and frees
+    //the old ones. declared last so it stops before anything it uses goes away
+    BackgroundBuilder<DelayStore, StoreSpec> storeBuilder{ "Delay Store Builder",
+                                                           [this] (const StoreSpec& spec) { return createStore(spec); } };
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayTutorialAudioProcessor)
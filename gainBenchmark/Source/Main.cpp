@@ -0,0 +1,328 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Timings and error for gainTutorial's GainEngine, against what
+    processBlock used to do: Decibels::decibelsToGain (std::pow) for the
+    block, then applyGainRamp. Run it with the names of the benchmarks to
+    run, or nothing for all of them, from a Release build.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../shared/Benchmark.h"
+#include "../../gainTutorial/Source/PluginProcessor.h"
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+//the processor hands the engine slices this long
+constexpr int sliceSize = 32;
+constexpr int numSamples = 48000;
+constexpr double rampSeconds = 0.02;
+
+//==============================================================================
+//the fast conversion's worst relative error against double precision over each range, and how long a
+//conversion takes next to Decibels::decibelsToGain, over an array so the fast one can vectorize
+void benchmarkConversion()
+{
+    std::printf("dB to gain, max relative error against double precision\n");
+    std::printf("%10s %14s %14s\n", "range dB", "exp2", "decibelsToGain");
+
+    for (float range : { 60.0f, 200.0f, 700.0f })
+    {
+        auto worstExp2 = 0.0, worstDecibels = 0.0;
+
+        for (int i = 0; i <= 1000000; ++i)
+        {
+            auto decibels = -range + 2.0f * range * (float) i / 1000000.0f;
+            auto exponent = decibels * 0.16609640474436813f;
+
+            if (std::abs(exponent) <= GainEngine::maxExponent)
+            {
+                auto exact = std::exp2((double) exponent);
+                worstExp2 = juce::jmax(worstExp2, std::abs((double) GainEngine::exp2(exponent) - exact) / exact);
+            }
+
+            auto exact = std::pow(10.0, (double) decibels / 20.0);
+            worstDecibels = juce::jmax(worstDecibels, std::abs((double) GainEngine::decibelsToGain(decibels) - exact) / exact);
+        }
+
+        std::printf("%10.0f %14.3g %14.3g\n", range, worstExp2, worstDecibels);
+    }
+
+    std::vector<float> decibels((size_t) numSamples), gains((size_t) numSamples);
+
+    for (int i = 0; i < numSamples; ++i)
+        decibels[(size_t) i] = -60.0f + 60.0f * (float) i / (float) numSamples;
+
+    auto fast = Benchmark::nsPerSample(numSamples, [&]
+    {
+        for (size_t i = 0; i < decibels.size(); ++i)
+            gains[i] = GainEngine::decibelsToGain(decibels[i]);
+    });
+
+    auto library = Benchmark::nsPerSample(numSamples, [&]
+    {
+        for (size_t i = 0; i < decibels.size(); ++i)
+            gains[i] = juce::Decibels::decibelsToGain(decibels[i]);
+    });
+
+    Benchmark::keep(gains.data(), numSamples);
+
+    std::printf("\nns per conversion\n");
+    std::printf("%14s %14s\n", "exp2", "decibelsToGain");
+    std::printf("%14.2f %14.2f\n", fast, library);
+}
+
+//==============================================================================
+//stereo, a slice at a time like processBlock. ramping, the target moves between -60 and 0 dB every 20 ms so
+//there's always a ramp going, with the phase flipping every other time; settled, it stays at -18 dB.
+//the old way only converts once a slice and ramps the gain in a straight line, so it's the cheapest but
+//isn't the same ramp, the middle column is what the dB ramp costs without the fast exp2
+void benchmarkRamp()
+{
+    //the same noise goes back in every run, it would all have been turned down to nothing otherwise
+    juce::AudioBuffer<float> input(2, numSamples), buffer(2, numSamples);
+    Benchmark::fillWithNoise(input);
+
+    auto rampLength = (int) (sampleRate * rampSeconds);
+    auto targetAt = [&] (int sample) { return (sample / rampLength) % 2 == 0 ? -60.0f : 0.0f; };
+    auto invertAt = [&] (int sample) { return (sample / (2 * rampLength)) % 2 == 1; };
+
+    GainEngine engine;
+    engine.reset(sampleRate, rampSeconds);
+
+    auto timeEngine = [&] (bool ramping)
+    {
+        engine.setCurrentAndTarget(-18.0f, false);
+
+        return Benchmark::nsPerSample(numSamples, [&]
+        {
+            buffer.makeCopyOf(input, true);
+
+            for (int start = 0; start < numSamples; start += sliceSize)
+            {
+                if (ramping)
+                    engine.setTarget(targetAt(start), invertAt(start));
+
+                engine.process(buffer, 2, start, sliceSize);
+            }
+        });
+    };
+
+    //the old way: the slice's gain from std::pow, then a linear ramp to it from the last one. the phase
+    //flipped the sign of the gain, so it ramped through 0 the same way
+    auto timeLibrary = [&] (bool ramping)
+    {
+        auto previousGain = juce::Decibels::decibelsToGain(-18.0f);
+
+        return Benchmark::nsPerSample(numSamples, [&]
+        {
+            buffer.makeCopyOf(input, true);
+
+            for (int start = 0; start < numSamples; start += sliceSize)
+            {
+                auto gain = juce::Decibels::decibelsToGain(ramping ? targetAt(start) : -18.0f);
+
+                if (ramping && invertAt(start))
+                    gain = -gain;
+
+                buffer.applyGainRamp(start, sliceSize, previousGain, gain);
+                previousGain = gain;
+            }
+        });
+    };
+
+    //GainEngine's ramp, in dB a sample at a time, but with decibelsToGain for every sample instead of exp2
+    auto timePerSample = [&] (bool ramping)
+    {
+        auto decibels = -18.0f, decibelStep = 0.0f, polarity = 1.0f, polarityStep = 0.0f;
+        auto targetDecibels = decibels, targetPolarity = polarity;
+        int countdown = 0;
+        std::array<float, sliceSize> gains;
+
+        return Benchmark::nsPerSample(numSamples, [&]
+        {
+            buffer.makeCopyOf(input, true);
+
+            for (int start = 0; start < numSamples; start += sliceSize)
+            {
+                if (ramping && (targetAt(start) != targetDecibels || (invertAt(start) ? -1.0f : 1.0f) != targetPolarity))
+                {
+                    targetDecibels = targetAt(start);
+                    targetPolarity = invertAt(start) ? -1.0f : 1.0f;
+                    countdown = rampLength;
+                    decibelStep = (targetDecibels - decibels) / (float) countdown;
+                    polarityStep = (targetPolarity - polarity) / (float) countdown;
+                }
+
+                for (auto& gain : gains)
+                {
+                    if (countdown > 0)
+                    {
+                        decibels += decibelStep;
+                        polarity += polarityStep;
+                        --countdown;
+                    }
+
+                    gain = polarity * juce::Decibels::decibelsToGain(decibels);
+                }
+
+                for (int channel = 0; channel < 2; ++channel)
+                    juce::FloatVectorOperations::multiply(buffer.getWritePointer(channel, start), gains.data(), sliceSize);
+            }
+        });
+    };
+
+    std::printf("stereo gain in %d sample slices, ns per sample frame\n", sliceSize);
+    std::printf("%10s %14s %26s %24s\n", "gain", "GainEngine", "decibelsToGain per sample", "decibelsToGain + ramp");
+
+    for (bool ramping : { true, false })
+    {
+        auto engineNs = timeEngine(ramping);
+        auto perSampleNs = timePerSample(ramping);
+        auto libraryNs = timeLibrary(ramping);
+        std::printf("%10s %14.2f %26.2f %24.2f\n", ramping ? "ramping" : "settled", engineNs, perSampleNs, libraryNs);
+    }
+
+    Benchmark::keep(buffer.getReadPointer(0), numSamples);
+}
+
+//==============================================================================
+//the whole processBlock at a few block sizes, stereo, with nothing moving
+void benchmarkProcessBlock()
+{
+    GainTutorialAudioProcessor processor;
+    Benchmark::setParameter(processor, "GAIN", -18.0f);
+
+    std::printf("processBlock, stereo at -18 dB, ns per sample frame\n");
+    std::printf("%10s %10s\n", "block", "ns");
+
+    for (int blockSize : { 32, 128, 512 })
+        std::printf("%10d %10.2f\n", blockSize, Benchmark::timeProcessor(processor, juce::AudioChannelSet::stereo(), blockSize, sampleRate));
+}
+
+//==============================================================================
+//how processBlock scales with the layout, from mono up to 16 channels, at -18 dB
+void benchmarkLayouts()
+{
+    constexpr int blockSize = 512;
+
+    GainTutorialAudioProcessor processor;
+    Benchmark::setParameter(processor, "GAIN", -18.0f);
+
+    std::printf("processBlock for each layout, %d sample blocks\n", blockSize);
+    Benchmark::printLayoutScaling(processor, blockSize, sampleRate);
+}
+
+//==============================================================================
+//what the editor's meters cost the audio thread. the kernels on their own first (a constant gain and a
+//ramp, with and without measuring), then the whole processBlock with the meter on and off, which also
+//has publish() copying every block out for the true peak thread
+void benchmarkMetering()
+{
+    constexpr int blockSize = 256;
+
+    {
+        juce::AudioBuffer<float> input(1, blockSize), buffer(1, blockSize);
+        Benchmark::fillWithNoise(input);
+        alignas(juce::dsp::SIMDRegister<float>) std::array<float, blockSize> gains;
+
+        for (int i = 0; i < blockSize; ++i)
+            gains[(size_t) i] = 0.125f + 0.5f * (float) i / (float) blockSize;
+
+        LevelMeter meter;
+        meter.prepare(sampleRate, 1);
+
+        auto time = [&] (auto&& process)
+        {
+            auto ns = Benchmark::nsPerSample(blockSize, [&]
+            {
+                buffer.copyFrom(0, 0, input, 0, 0, blockSize);
+                process(buffer.getWritePointer(0));
+            });
+
+            Benchmark::keep(buffer.getReadPointer(0), blockSize);
+            return ns;
+        };
+
+        auto constantOff = time([&] (float* samples) { juce::FloatVectorOperations::multiply(samples, 0.125f, blockSize); });
+        auto constantOn = time([&] (float* samples) { meter.multiply(0, samples, 0.125f, blockSize); });
+        auto rampOff = time([&] (float* samples) { juce::FloatVectorOperations::multiply(samples, gains.data(), blockSize); });
+        //lined up with each other, like GainEngine's, the gains load a register at a time in the same pass
+        auto rampOn = time([&] (float* samples) { meter.multiply(0, samples, gains.data(), blockSize); });
+        //one sample in, so the samples aren't lined up with the gains and it takes two passes
+        auto unalignedOff = time([&] (float* samples) { juce::FloatVectorOperations::multiply(samples + 1, gains.data(), blockSize - 1); });
+        auto unalignedOn = time([&] (float* samples) { meter.multiply(0, samples + 1, gains.data(), blockSize - 1); });
+
+        std::printf("gain kernel, %d samples with the copy in, ns per sample\n", blockSize);
+        std::printf("%10s %10s %10s %10s\n", "gain", "multiply", "metered", "overhead");
+        std::printf("%10s %10.2f %10.2f %9.0f%%\n", "constant", constantOff, constantOn, 100.0 * (constantOn / constantOff - 1.0));
+        std::printf("%10s %10.2f %10.2f %9.0f%%\n", "ramp", rampOff, rampOn, 100.0 * (rampOn / rampOff - 1.0));
+        std::printf("%10s %10.2f %10.2f %9.0f%%\n\n", "unaligned", unalignedOff, unalignedOn, 100.0 * (unalignedOn / unalignedOff - 1.0));
+    }
+
+    GainTutorialAudioProcessor processor;
+    Benchmark::setParameter(processor, "GAIN", -18.0f);
+
+    std::printf("processBlock at -18 dB, %d sample blocks, ns per channel per sample\n", blockSize);
+    std::printf("%12s %10s %10s %10s\n", "layout", "meter off", "meter on", "overhead");
+
+    for (auto& layout : Benchmark::getLayouts())
+    {
+        auto numChannels = (double) layout.channels.size();
+
+        processor.getMeter().setActive(false);
+        auto off = Benchmark::timeProcessor(processor, layout.channels, blockSize, sampleRate) / numChannels;
+
+        processor.getMeter().setActive(true);
+        auto on = Benchmark::timeProcessor(processor, layout.channels, blockSize, sampleRate) / numChannels;
+        processor.getMeter().setActive(false);
+
+        std::printf("%12s %10.2f %10.2f %9.0f%%\n", layout.name, off, on, 100.0 * (on / off - 1.0));
+    }
+}
+
+//==============================================================================
+struct Section
+{
+    const char* name;
+    void (*run)();
+};
+
+const Section sections[]{
+    { "conversion", benchmarkConversion },
+    { "ramp", benchmarkRamp },
+    { "processblock", benchmarkProcessBlock },
+    { "layouts", benchmarkLayouts },
+    { "metering", benchmarkMetering },
+};
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto& section : sections)
+    {
+        auto requested = argc < 2;
+
+        for (int i = 1; i < argc; ++i)
+            requested = requested || juce::String(argv[i]) == section.name;
+
+        if (requested)
+        {
+            section.run();
+            std::printf("\n");
+        }
+    }
+
+    return 0;
+}
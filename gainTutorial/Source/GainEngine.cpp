@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    GainEngine.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "GainEngine.h"
+
+void GainEngine::reset(double sampleRate, double rampSeconds) noexcept
+{
+    rampLength = juce::jmax(0, (int) std::floor(sampleRate * rampSeconds));
+    countdown = 0;
+    currentDecibels = targetDecibels;
+    currentPolarity = targetPolarity;
+}
+
+void GainEngine::setTarget(float decibels, bool invertPhase) noexcept
+{
+    decibels = juce::jlimit(-maxDecibels, maxDecibels, decibels);
+    auto polarity = invertPhase ? -1.0f : 1.0f;
+
+    if (decibels == targetDecibels && polarity == targetPolarity)
+        return;
+
+    //carry on from wherever the last ramp got to
+    targetDecibels = decibels;
+    targetPolarity = polarity;
+    targetGain = polarity * decibelsToGain(decibels);
+
+    if (rampLength == 0)
+    {
+        setCurrentAndTarget(decibels, invertPhase);
+        return;
+    }
+
+    countdown = rampLength;
+    decibelStep = (targetDecibels - currentDecibels) / (float) countdown;
+    polarityStep = (targetPolarity - currentPolarity) / (float) countdown;
+}
+
+void GainEngine::setCurrentAndTarget(float decibels, bool invertPhase) noexcept
+{
+    currentDecibels = targetDecibels = juce::jlimit(-maxDecibels, maxDecibels, decibels);
+    currentPolarity = targetPolarity = invertPhase ? -1.0f : 1.0f;
+    targetGain = targetPolarity * decibelsToGain(targetDecibels);
+    countdown = 0;
+}
+
+float GainEngine::getCurrentGain() const noexcept
+{
+    return countdown == 0 ? targetGain : currentPolarity * decibelsToGain(currentDecibels);
+}
+
+void GainEngine::process(juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples, LevelMeter* meter) noexcept
+{
+    //a chunk of ramp at a time, and once it settles part way through the rest is a constant gain
+    for (int position = 0; position < numSamples;)
+    {
+        if (countdown == 0)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* samples = buffer.getWritePointer(channel, startSample + position);
+
+                //metering goes through even at 0 dB, the multiply is what it measures in
+                if (meter != nullptr)
+                    meter->multiply(channel, samples, targetGain, numSamples - position);
+                else if (targetGain != 1.0f)
+                    juce::FloatVectorOperations::multiply(samples, targetGain, numSamples - position);
+            }
+
+            return;
+        }
+
+        auto chunk = juce::jmin(chunkSize, countdown, numSamples - position);
+        fillRamp(chunk);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = buffer.getWritePointer(channel, startSample + position);
+
+            if (meter != nullptr)
+                meter->multiply(channel, samples, ramp.data(), chunk);
+            else
+                juce::FloatVectorOperations::multiply(samples, ramp.data(), chunk);
+        }
+
+        position += chunk;
+    }
+}
+
+void GainEngine::fillRamp(int numSamples) noexcept
+{
+    //the last sample of the ramp is the target exactly
+    if (numSamples == countdown)
+    {
+        fillRamp(numSamples - 1);
+        ramp[(size_t) numSamples - 1] = targetGain;
+        currentDecibels = targetDecibels;
+        currentPolarity = targetPolarity;
+        countdown = 0;
+        return;
+    }
+
+    //no clamping in here (it stops the loop vectorizing), the ends of the ramp already are
+    auto* gains = ramp.data();
+    auto decibels = currentDecibels, dbStep = decibelStep;
+    auto polarity = currentPolarity, pStep = polarityStep;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto n = (float) (i + 1);
+        gains[i] = (polarity + pStep * n) * decibelsToGain(decibels + dbStep * n);
+    }
+
+    currentDecibels += decibelStep * (float) numSamples;
+    currentPolarity += polarityStep * (float) numSamples;
+    countdown -= numSamples;
+}
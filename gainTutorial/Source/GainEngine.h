@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    GainEngine.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Gain and phase inversion for a whole block, ramped in dB with a fast
+    exp2 instead of std::pow.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LevelMeter.h"
+
+//==============================================================================
+/**
+    The target is a level in dB and a polarity (1 or -1). When either one
+    moves, both ramp per sample for rampSeconds: the level in a straight
+    line in dB (so a fade sounds even all the way, instead of most of it
+    happening at the quiet end like a linear gain ramp), and the polarity
+    in a straight line from 1 to -1 or back, going through 0 half way so
+    flipping the phase doesn't click. Each sample's gain is then
+
+        polarity * 2^(dB * log2(10) / 20)
+
+    so the phase costs nothing extra, it's in the same multiply as the
+    level. Once the ramp is over the gain is worked out once and it's one
+    multiply per sample, or nothing at all at 0 dB.
+
+    The ramps are start + step * n with nothing carried from one sample to
+    the next, and the exp2 is a polynomial plus some bit twiddling with no
+    branches, so the compiler vectorizes the whole thing 4 or 8 wide.
+*/
+class GainEngine
+{
+public:
+    //valid range of exp2(), a float's exponent runs out past this
+    static constexpr float maxExponent = 126.0f;
+
+    //--------------------------------------------------------------------------
+    /** 2^x for |x| <= maxExponent, no clamping or checks.
+
+        x is split into the nearest whole number n and f = x - n in [-0.5, 0.5].
+        2^f is a degree 6 minimax polynomial (the Cephes exp2f one) and 2^n goes
+        straight into the float's exponent bits.
+
+        Relative error against double precision exp2 is under 1.1e-7 over the
+        whole range, and exp2 of a whole number is exact, so 0 dB is exactly 1.
+        Vectorized it's about 10x quicker than Decibels::decibelsToGain, or
+        40x with AVX2 and FMA (gainBenchmark's conversion section).
+    */
+    static forcedinline float exp2(float x) noexcept
+    {
+        //adding and taking away 1.5 * 2^23 rounds to the nearest whole number
+        auto n = (x + 12582912.0f) - 12582912.0f;
+        auto f = x - n;
+
+        auto p = 1.535336188319500e-4f;
+        p = p * f + 1.339887440266574e-3f;
+        p = p * f + 9.618437357674640e-3f;
+        p = p * f + 5.550332471162809e-2f;
+        p = p * f + 2.402264791363012e-1f;
+        p = p * f + 6.931472028550421e-1f;
+        p = p * f + 1.0f;
+
+        auto bits = ((std::int32_t) n + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+
+        return p * scale;
+    }
+
+    /** 10^(dB / 20) through exp2(), for anything from -760 to 760 dB.
+
+        Rounding dB * log2(10) / 20 to a float adds error that grows with the
+        level: relative error is under 5e-7 between -60 and 60 dB (0.000004 dB),
+        under 1.5e-6 out to +-200 dB and under 3e-6 out to +-700 dB.
+    */
+    static forcedinline float decibelsToGain(float decibels) noexcept
+    {
+        return exp2(decibels * log2Of10Over20);
+    }
+
+    //--------------------------------------------------------------------------
+    GainEngine() = default;
+
+    //jumps to the target, no ramp
+    void reset(double sampleRate, double rampSeconds) noexcept;
+
+    //decibels is clamped to +-maxDecibels
+    void setTarget(float decibels, bool invertPhase) noexcept;
+    void setCurrentAndTarget(float decibels, bool invertPhase) noexcept;
+
+    bool isSettled() const noexcept { return countdown == 0; }
+    //gain the ramp has got to, with the polarity in it
+    float getCurrentGain() const noexcept;
+
+    //multiply the first numChannels channels of buffer by the gain, from startSample on. with a meter
+    //the samples get measured in the same pass as the multiply
+    void process(juce::AudioBuffer<float>& buffer, int numChannels, int startSample, int numSamples,
+                 LevelMeter* meter = nullptr) noexcept;
+
+private:
+    static constexpr float log2Of10Over20 = 0.16609640474436813f;
+    //keeps the exponent well inside exp2's range
+    static constexpr float maxDecibels = 600.0f;
+    static constexpr int chunkSize = 64;
+
+    //gains for the next numSamples samples of the ramp into ramp, and move it on
+    void fillRamp(int numSamples) noexcept;
+
+    float currentDecibels{ 0.0f }, targetDecibels{ 0.0f }, decibelStep{ 0.0f };
+    float currentPolarity{ 1.0f }, targetPolarity{ 1.0f }, polarityStep{ 0.0f };
+    //the target as a gain, worked out once when it's set
+    float targetGain{ 1.0f };
+    int countdown{ 0 };
+    int rampLength{ 0 };
+
+    //aligned, so the meter can load it a register at a time alongside samples that are
+    alignas(juce::dsp::SIMDRegister<float>) std::array<float, chunkSize> ramp{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GainEngine)
+};
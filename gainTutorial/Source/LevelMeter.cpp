@@ -0,0 +1,310 @@
+/*
+  ==============================================================================
+
+    LevelMeter.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "LevelMeter.h"
+
+namespace
+{
+    //ITU-R BS.1770-4 annex 2, the 4 phases of the 4x upsampling filter
+    constexpr float truePeakCoefficients[4][12] {
+        {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+           0.9721679687500f, -0.1022949218750f,  0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+        { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+           0.7797851562500f, -0.2003173828125f,  0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+        { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+           0.4650878906250f, -0.1665039062500f,  0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+        { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+           0.1373291015625f, -0.0594482421875f,  0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f },
+    };
+
+    //the RMS average
+    constexpr double rmsSeconds = 0.3;
+    //how far the true peak can fall behind the audio before samples get left out
+    constexpr double fifoSeconds = 0.5;
+}
+
+LevelMeter::~LevelMeter()
+{
+    setActive(false);
+}
+
+void LevelMeter::prepare(double newSampleRate, int newNumChannels)
+{
+    const juce::ScopedLock lock(registrationLock);
+
+    //the background thread can't be reading the FIFO while it's reallocated
+    if (registered)
+        meterThread->removeTimeSliceClient(this);
+
+    sampleRate = newSampleRate;
+    numChannels.store(juce::jlimit(0, maxChannels, newNumChannels), std::memory_order_relaxed);
+    decayLength = 0;
+
+    //AbstractFifo keeps one slot free, hence the + 1
+    auto capacity = juce::roundToInt(sampleRate * fifoSeconds) + 1;
+    fifo.setTotalSize(capacity);
+    fifoBuffer.setSize(getNumChannels(), capacity);
+
+    for (auto& state : channels)
+    {
+        state.peak.store(0.0f, std::memory_order_relaxed);
+        state.rms.store(0.0f, std::memory_order_relaxed);
+        state.truePeak.store(0.0f, std::memory_order_relaxed);
+        state.blockPeak = state.blockSumOfSquares = state.meanSquare = 0.0f;
+        state.blockLength = 0;
+        state.history.fill(0.0f);
+    }
+
+    if (registered)
+        meterThread->addTimeSliceClient(this);
+}
+
+void LevelMeter::setActive(bool shouldBeActive)
+{
+    const juce::ScopedLock lock(registrationLock);
+
+    active.store(shouldBeActive, std::memory_order_relaxed);
+
+    if (shouldBeActive == registered)
+        return;
+
+    //removing waits for a slice that's already running, so nothing's left using this afterwards
+    if (shouldBeActive)
+        meterThread->addTimeSliceClient(this);
+    else
+        meterThread->removeTimeSliceClient(this);
+
+    registered = shouldBeActive;
+}
+
+template <typename GainAt, typename GainsAt>
+void LevelMeter::measure(Channel& state, float* samples, int numSamples, GainAt&& gainAt, GainsAt&& gainsAt) noexcept
+{
+    auto peak = 0.0f, sumOfSquares = 0.0f;
+
+    auto measureSample = [&] (int i)
+    {
+        auto value = samples[i] *= gainAt(i);
+        peak = juce::jmax(peak, std::abs(value));
+        sumOfSquares += value * value;
+    };
+
+    //one at a time up to where the SIMD loads can start
+    auto head = juce::jmin((int) (Vec::getNextSIMDAlignedPtr(samples) - samples), numSamples);
+    int i = 0;
+
+    for (; i < head; ++i)
+        measureSample(i);
+
+    //two registers at a time with an accumulator each, so each max and add doesn't wait on the one before
+    auto zero = Vec::expand(0.0f);
+    Vec peaks[2] = { zero, zero }, sums[2] = { zero, zero };
+
+    auto measureRegister = [&] (int at, int accumulator)
+    {
+        auto value = Vec::fromRawArray(samples + at) * gainsAt(at);
+        value.copyToRawArray(samples + at);
+
+        peaks[accumulator] = Vec::max(peaks[accumulator], Vec::max(value, zero - value));
+        sums[accumulator] += value * value;
+    };
+
+    for (; numSamples - i >= 2 * lanes; i += 2 * lanes)
+    {
+        measureRegister(i, 0);
+        measureRegister(i + lanes, 1);
+    }
+
+    if (numSamples - i >= lanes)
+    {
+        measureRegister(i, 0);
+        i += lanes;
+    }
+
+    for (; i < numSamples; ++i)
+        measureSample(i);
+
+    sumOfSquares += (sums[0] + sums[1]).sum();
+
+    auto peakLanes = Vec::max(peaks[0], peaks[1]);
+
+    for (size_t lane = 0; lane < (size_t) lanes; ++lane)
+        peak = juce::jmax(peak, peakLanes.get(lane));
+
+    state.blockPeak = juce::jmax(state.blockPeak, peak);
+    state.blockSumOfSquares += sumOfSquares;
+    state.blockLength += numSamples;
+}
+
+void LevelMeter::multiply(int channel, float* samples, float gain, int numSamples) noexcept
+{
+    if (channel >= getNumChannels())
+    {
+        juce::FloatVectorOperations::multiply(samples, gain, numSamples);
+        return;
+    }
+
+    auto gains = Vec::expand(gain);
+
+    measure(channels[(size_t) channel], samples, numSamples,
+            [gain] (int) { return gain; },
+            [gains] (int) { return gains; });
+}
+
+void LevelMeter::multiply(int channel, float* samples, const float* gains, int numSamples) noexcept
+{
+    if (channel >= getNumChannels())
+    {
+        juce::FloatVectorOperations::multiply(samples, gains, numSamples);
+        return;
+    }
+
+    //the gains load a register at a time wherever the samples do, so they have to be the same distance
+    //from a SIMD boundary (GainEngine's are). otherwise it's the multiply and then a second pass to measure
+    auto head = (int) (Vec::getNextSIMDAlignedPtr(samples) - samples);
+
+    if (head < numSamples && ! Vec::isSIMDAligned(gains + head))
+    {
+        juce::FloatVectorOperations::multiply(samples, gains, numSamples);
+        multiply(channel, samples, 1.0f, numSamples);
+        return;
+    }
+
+    measure(channels[(size_t) channel], samples, numSamples,
+            [gains] (int i) { return gains[i]; },
+            [gains] (int i) { return Vec::fromRawArray(gains + i); });
+}
+
+void LevelMeter::publish(const juce::AudioBuffer<float>& output) noexcept
+{
+    auto numToMeter = juce::jmin(getNumChannels(), output.getNumChannels());
+
+    for (int channel = 0; channel < numToMeter; ++channel)
+    {
+        auto& state = channels[(size_t) channel];
+
+        if (state.blockLength == 0)
+            continue;
+
+        //a one pole over the blocks instead of every sample, decayed by however long the block was
+        if (state.blockLength != decayLength)
+        {
+            decayLength = state.blockLength;
+            decay = (float) std::exp(-(double) decayLength / (rmsSeconds * sampleRate));
+        }
+
+        state.meanSquare = decay * state.meanSquare + (1.0f - decay) * state.blockSumOfSquares / (float) state.blockLength;
+        state.rms.store(std::sqrt(state.meanSquare), std::memory_order_relaxed);
+
+        //the samples themselves count towards the true peak too, the filter's phases don't go through them exactly
+        raise(state.peak, state.blockPeak);
+        raise(state.truePeak, state.blockPeak);
+
+        state.blockPeak = state.blockSumOfSquares = 0.0f;
+        state.blockLength = 0;
+    }
+
+    //whatever doesn't fit is dropped, prepareToWrite only hands out the free space
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(output.getNumSamples(), start1, size1, start2, size2);
+
+    for (int channel = 0; channel < numToMeter; ++channel)
+    {
+        if (size1 > 0)
+            fifoBuffer.copyFrom(channel, start1, output, channel, 0, size1);
+
+        if (size2 > 0)
+            fifoBuffer.copyFrom(channel, start2, output, channel, size1, size2);
+    }
+
+    fifo.finishedWrite(size1 + size2);
+}
+
+int LevelMeter::useTimeSlice()
+{
+    //a piece at a time until it's caught up
+    while (fifo.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(pieceSize, start1, size1, start2, size2);
+        auto length = size1 + size2;
+
+        for (int channel = 0; channel < getNumChannels(); ++channel)
+        {
+            auto& state = channels[(size_t) channel];
+            auto* input = scratch.data() + historySize;
+
+            std::copy(state.history.begin(), state.history.end(), scratch.begin());
+            std::copy_n(fifoBuffer.getReadPointer(channel, start1), size1, input);
+
+            if (size2 > 0)
+                std::copy_n(fifoBuffer.getReadPointer(channel, start2), size2, input + size1);
+
+            raise(state.truePeak, getTruePeak(input, length));
+
+            //the end of this piece is the start of the next one's filter
+            std::copy_n(input + length - historySize, historySize, state.history.begin());
+        }
+
+        fifo.finishedRead(length);
+    }
+
+    return pollMs;
+}
+
+float LevelMeter::getTruePeak(const float* samples, int numSamples) noexcept
+{
+    auto* start = samples - historySize;
+    auto highest = 0.0f;
+
+    //each phase a tap at a time across the piece, so the inner loop vectorizes
+    for (auto& phase : truePeakCoefficients)
+    {
+        std::fill(outputs.begin(), outputs.begin() + numSamples, 0.0f);
+
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            auto coefficient = phase[tap];
+            auto* input = start + tap;
+
+            for (int i = 0; i < numSamples; ++i)
+                outputs[(size_t) i] += coefficient * input[i];
+        }
+
+        auto range = juce::FloatVectorOperations::findMinAndMax(outputs.data(), numSamples);
+        highest = juce::jmax(highest, range.getEnd(), -range.getStart());
+    }
+
+    return highest;
+}
+
+LevelMeter::Levels LevelMeter::read(int channel) noexcept
+{
+    auto& state = channels[(size_t) channel];
+
+    return { state.peak.exchange(0.0f, std::memory_order_relaxed),
+             state.rms.load(std::memory_order_relaxed),
+             state.truePeak.load(std::memory_order_relaxed) };
+}
+
+void LevelMeter::clearTruePeaks() noexcept
+{
+    for (auto& state : channels)
+        state.truePeak.store(0.0f, std::memory_order_relaxed);
+}
+
+void LevelMeter::raise(std::atomic<float>& value, float level) noexcept
+{
+    auto current = value.load(std::memory_order_relaxed);
+
+    while (level > current && ! value.compare_exchange_weak(current, level, std::memory_order_relaxed))
+    {
+    }
+}
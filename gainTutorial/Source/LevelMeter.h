@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    LevelMeter.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Per channel peak, RMS and true peak of the output, measured while the
+    gain gets applied and handed to the editor through atomics.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    multiply() is the gain and the peak and RMS in one go: every sample
+    gets multiplied, written back and measured while it's still in a
+    register, in SIMDRegister lanes, so the samples don't get read again
+    just for the meters. A gain ramp goes through the same loop, its gains
+    loaded a register at a time next to the samples, as long as they're
+    the same distance from a SIMD boundary (GainEngine's are); if they
+    aren't it's the multiply and then a second pass with a gain of 1.
+
+    It doesn't make the 5% of processBlock it was meant to: the gain is
+    one multiply a sample, and the abs, max, square and add on top of it
+    are more arithmetic than that, before publish() copies the block out.
+    gainBenchmark's "metering" section has it at 40 to 80% on the kernels
+    and 30 to 120% on processBlock depending on the layout, 6 to 24 times
+    the budget. Turning the meter off when no editor is open (below)
+    is what keeps that off the audio thread the rest of the time.
+
+    Nothing goes to the editor until publish() at the end of the block.
+    Peak is the highest level since the editor last read it: the audio
+    thread raises the atomic with a compare and swap and the editor takes
+    it with an exchange back to 0, so neither ever waits on the other and
+    no peak between two frames gets lost. RMS is a 300 ms running average,
+    the editor just loads it.
+
+    True peak is ITU-R BS.1770's: the output upsampled 4x through its 48
+    tap polyphase FIR, held at the highest it's been until the editor
+    clears it. 48 multiplies a sample is many times what the gain costs,
+    so the audio thread doesn't do it. publish() copies the block into a
+    wait-free single producer, single consumer FIFO (juce::AbstractFifo)
+    and a background thread runs the filter over it. If that thread ever
+    falls half a second behind, the samples that don't fit are left out
+    of the true peak (the sample peak still counts towards it).
+
+    The processor only hands the meter to GainEngine while an editor has
+    called setActive(true), so with no editor open none of it runs.
+*/
+class LevelMeter  : private juce::TimeSliceClient
+{
+public:
+    //surround and ambisonic layouts go up to 16 (see ChannelLayouts)
+    static constexpr int maxChannels = 16;
+
+    struct Levels
+    {
+        float peak, rms, truePeak;
+    };
+
+    LevelMeter() = default;
+    ~LevelMeter() override;
+
+    //allocates the FIFO, so never on the audio thread
+    void prepare(double sampleRate, int numChannels);
+
+    //message thread: the editor turns it on while it's open
+    void setActive(bool shouldBeActive);
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    //audio thread: samples *= gain (or gains[i]) in place, measuring the result for channel
+    void multiply(int channel, float* samples, float gain, int numSamples) noexcept;
+    void multiply(int channel, float* samples, const float* gains, int numSamples) noexcept;
+    //audio thread: hand the block's levels to the editor and its output to the true peak, once a block
+    void publish(const juce::AudioBuffer<float>& output) noexcept;
+
+    //message thread: peak since the last read, RMS now and the held true peak, as gains
+    Levels read(int channel) noexcept;
+    void clearTruePeaks() noexcept;
+    int getNumChannels() const noexcept { return numChannels.load(std::memory_order_relaxed); }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanes = (int) Vec::size();
+
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int historySize = tapsPerPhase - 1;
+    //samples the true peak filter runs over in one go
+    static constexpr int pieceSize = 256;
+    //how often the background thread looks for more
+    static constexpr int pollMs = 10;
+
+    //the thread every meter's true peak runs on
+    struct MeterThread  : public juce::TimeSliceThread
+    {
+        MeterThread() : juce::TimeSliceThread("Gain Level Meter") { startThread(); }
+        ~MeterThread() override { stopThread(1000); }
+    };
+
+    struct Channel
+    {
+        //what the editor reads
+        std::atomic<float> peak{ 0.0f }, rms{ 0.0f }, truePeak{ 0.0f };
+
+        //audio thread only: what's been measured since publish(), and the running mean square
+        float blockPeak{ 0.0f }, blockSumOfSquares{ 0.0f };
+        int blockLength{ 0 };
+        float meanSquare{ 0.0f };
+
+        //background thread only: the last samples, where the next piece's filter starts from
+        std::array<float, historySize> history{};
+    };
+
+    //samples *= gainAt(i), or gainsAt(i) a register at a time from an aligned i, added to state's levels
+    template <typename GainAt, typename GainsAt>
+    void measure(Channel& state, float* samples, int numSamples, GainAt&& gainAt, GainsAt&& gainsAt) noexcept;
+
+    //background thread: run the true peak filter over whatever's in the FIFO
+    int useTimeSlice() override;
+    //the highest the filter's 4 phases get over samples (with historySize samples before them)
+    float getTruePeak(const float* samples, int numSamples) noexcept;
+
+    //raise value to at least level, leaving it alone if it's already higher
+    static void raise(std::atomic<float>& value, float level) noexcept;
+
+    std::array<Channel, maxChannels> channels;
+    std::atomic<int> numChannels{ 0 };
+    std::atomic<bool> active{ false };
+
+    double sampleRate{ 44100.0 };
+    //decay of the mean square over the last block length, only recalculated when that changes
+    int decayLength{ 0 };
+    float decay{ 0.0f };
+
+    //output on its way to the true peak, half a second of it
+    juce::AbstractFifo fifo{ 1 };
+    juce::AudioBuffer<float> fifoBuffer;
+
+    //background thread only: history plus a piece to run the filter over without wrapping, and
+    //what comes out of one phase
+    std::array<float, historySize + pieceSize> scratch{};
+    std::array<float, pieceSize> outputs{};
+
+    juce::SharedResourcePointer<MeterThread> meterThread;
+    //held while the background thread is added or taken off, prepare() and setActive() can be on different threads
+    juce::CriticalSection registrationLock;
+    bool registered{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
+};
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    MeterDisplay.cpp
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+  ==============================================================================
+*/
+
+#include "MeterDisplay.h"
+
+MeterDisplay::MeterDisplay(LevelMeter& meterToShow)
+    : meter(meterToShow)
+{
+    meter.setActive(true);
+    startTimerHz(frameRate);
+}
+
+MeterDisplay::~MeterDisplay()
+{
+    stopTimer();
+    meter.setActive(false);
+}
+
+void MeterDisplay::timerCallback()
+{
+    auto newNumChannels = meter.getNumChannels();
+    auto changed = newNumChannels != numChannels;
+    numChannels = newNumChannels;
+
+    //the peak line drops this much a frame unless something louder comes along
+    auto fall = juce::Decibels::decibelsToGain(-fallRate / (float) frameRate);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto levels = meter.read(channel);
+        auto index = (size_t) channel;
+
+        auto peak = juce::jmax(levels.peak, peaks[index] * fall);
+        auto truePeak = levels.truePeak;
+
+        //nothing to redraw once it's all fallen off the bottom
+        if (peak < juce::Decibels::decibelsToGain(minDecibels))
+            peak = 0.0f;
+
+        changed = changed || peak != peaks[index] || levels.rms != rmsLevels[index] || truePeak != truePeaks[index];
+        peaks[index] = peak;
+        rmsLevels[index] = levels.rms;
+        truePeaks[index] = truePeak;
+    }
+
+    if (changed)
+        repaint();
+}
+
+void MeterDisplay::mouseDown(const juce::MouseEvent&)
+{
+    meter.clearTruePeaks();
+    truePeaks.fill(0.0f);
+    repaint();
+}
+
+float MeterDisplay::getY(float gain, float height) const noexcept
+{
+    auto decibels = juce::jlimit(minDecibels, maxDecibels, juce::Decibels::gainToDecibels(gain, minDecibels));
+    return height * (maxDecibels - decibels) / (maxDecibels - minDecibels);
+}
+
+void MeterDisplay::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+
+    if (numChannels == 0)
+        return;
+
+    auto bounds = getLocalBounds().toFloat();
+    auto labels = bounds.removeFromTop(16.0f);
+    auto height = bounds.getHeight();
+    auto barWidth = bounds.getWidth() / (float) numChannels;
+
+    //0 dB across all the bars
+    g.setColour(juce::Colours::darkgrey);
+    g.drawHorizontalLine(juce::roundToInt(bounds.getY() + getY(1.0f, height)), bounds.getX(), bounds.getRight());
+
+    g.setFont(juce::jmin(12.0f, barWidth * 0.45f));
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto index = (size_t) channel;
+        auto bar = bounds.withX(bounds.getX() + barWidth * (float) channel).withWidth(barWidth).reduced(1.0f, 0.0f);
+
+        auto rmsY = getY(rmsLevels[index], height);
+        g.setColour(juce::Colours::limegreen);
+        g.fillRect(bar.withTrimmedTop(rmsY));
+
+        auto peakY = getY(peaks[index], height);
+        g.setColour(peaks[index] > 1.0f ? juce::Colours::red : juce::Colours::white);
+        g.fillRect(bar.withY(bar.getY() + peakY).withHeight(2.0f));
+
+        //highest true peak so far in dBTP, one decimal place
+        auto truePeak = truePeaks[index];
+        auto text = truePeak > 0.0f ? juce::String(juce::Decibels::gainToDecibels(truePeak), 1) : juce::String("-inf");
+        g.setColour(truePeak > 1.0f ? juce::Colours::red : juce::Colours::lightgrey);
+        g.drawFittedText(text, labels.withX(bar.getX()).withWidth(bar.getWidth()).toNearestInt(), juce::Justification::centred, 1);
+    }
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    MeterDisplay.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Bar meters for the LevelMeter, one per channel.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LevelMeter.h"
+
+//==============================================================================
+/**
+    A timer reads the meter frameRate times a second, and only repaints
+    when what's on screen would change, so the display never draws faster
+    than that however small the host's blocks are.
+
+    Each channel is an RMS bar with a peak line that falls at fallRate, and
+    the highest true peak so far is written above it (red over 0 dBTP).
+    Clicking clears the true peaks.
+
+    The meter only runs on the audio thread while one of these is showing
+    it: the constructor turns it on and the destructor off.
+*/
+class MeterDisplay  : public juce::Component,
+                      private juce::Timer
+{
+public:
+    explicit MeterDisplay(LevelMeter& meterToShow);
+    ~MeterDisplay() override;
+
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& event) override;
+
+private:
+    static constexpr int frameRate = 30;
+    //dB per second the peak line falls at
+    static constexpr float fallRate = 20.0f;
+    //shown range
+    static constexpr float minDecibels = -60.0f;
+    static constexpr float maxDecibels = 6.0f;
+
+    void timerCallback() override;
+
+    float getY(float gain, float height) const noexcept;
+
+    LevelMeter& meter;
+    int numChannels{ 0 };
+
+    //what's on screen, as gains
+    std::array<float, LevelMeter::maxChannels> peaks{}, rmsLevels{}, truePeaks{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeterDisplay)
+};
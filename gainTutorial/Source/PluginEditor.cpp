@@ -11,7 +11,7 @@
 
 //==============================================================================
 GainTutorialAudioProcessorEditor::GainTutorialAudioProcessorEditor(GainTutorialAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), meterDisplay(p.getMeter()), audioProcessor(p)
 
 {
     //GAIN SLIDER
@@ -38,6 +38,9 @@ GainTutorialAudioProcessorEditor::GainTutorialAudioProcessorEditor(GainTutorialA
     welcomeLabel.setColour(juce::Label::textColourId, juce::Colours::blue);
     //welcomeLabel.setJustificationType(juce::Justification::centredTop);
 
+    //METERS
+    addAndMakeVisible(meterDisplay);
+
 
     ////STATE LABEL
     //addAndMakeVisible(stateLabel);
@@ -46,7 +49,7 @@ GainTutorialAudioProcessorEditor::GainTutorialAudioProcessorEditor(GainTutorialA
 
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (300, 300);
+    setSize (400, 300);
 }
 
 GainTutorialAudioProcessorEditor::~GainTutorialAudioProcessorEditor()
@@ -64,13 +67,17 @@ void GainTutorialAudioProcessorEditor::resized()
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
 
-    mGainSlider.setBounds(getWidth() / 2 - 50, getHeight() / 2 - 75, 100, 150);
+    //meters take the right hand side, the controls stay centred in what's left
+    meterDisplay.setBounds(getLocalBounds().removeFromRight(100).reduced(10));
+    auto centreX = (getWidth() - 100) / 2;
+
+    mGainSlider.setBounds(centreX - 50, getHeight() / 2 - 75, 100, 150);
 
     
-    mPhaseButton.setBounds(getWidth() / 2 - 50, getHeight() / 2 + 20, 100, 150);
+    mPhaseButton.setBounds(centreX - 50, getHeight() / 2 + 20, 100, 150);
     mPhaseButton.changeWidthToFitText();
 
-    welcomeLabel.setBounds(getWidth() / 2 - 100, getHeight() / 2 - 120, 200, 30);
+    welcomeLabel.setBounds(centreX - 100, getHeight() / 2 - 120, 200, 30);
     
 }
 
@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "MeterDisplay.h"
 
 //==============================================================================
 /**
@@ -34,6 +35,8 @@ private:
     juce::ToggleButton mPhaseButton;
     juce::Label stateLabel;
     juce::Label welcomeLabel;
+    //output levels, down the right hand side
+    MeterDisplay meterDisplay;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainSliderAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> phaseButtonAttachment;
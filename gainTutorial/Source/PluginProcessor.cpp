@@ -24,15 +24,13 @@ GainTutorialAudioProcessor::GainTutorialAudioProcessor()
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        //below is initializer list
-                       //apvts descrip: *this deferences pointer to AudioProcessor object, nullptr becuase we aren't using undo manager, createParameters() returns ParameterLayout object
+                       //apvts descrip: *this deferences pointer to AudioProcessor object, nullptr becuase we aren't using undo manager, createLayout() makes the ParameterLayout object from parameterTable
                        ), 
-                       apvts(*this, nullptr, juce::Identifier("Parameters"), createParameters())
+                       apvts(*this, nullptr, juce::Identifier("Parameters"), ParameterTable::createLayout(parameterTable))
                        
 #endif
 //start actual code of constructor
 {
-    phaseParam = apvts.getRawParameterValue("INVERT_PHASE");
-    gainParam = apvts.getRawParameterValue("GAIN");
 }
 
 
@@ -109,12 +107,12 @@ void GainTutorialAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
-    //get previous value of phase parameter. If value < 0.5, set phase = 1.0. Else, phase = 1.0f
-    auto phase = *phaseParam < 0.5f ? 1.0f : -1.0f;
-    //account for phase
-    previousGain = *gainParam;
-    previousGain = juce::Decibels::decibelsToGain(previousGain) * phase;
-    
+    //start at the current gain and phase instead of ramping up from nothing
+    gainEngine.reset(sampleRate, 0.02);
+    gainEngine.setCurrentAndTarget(paramValues.get(Param::Gain), paramValues.getBool(Param::InvertPhase));
+    meter.prepare(sampleRate, getTotalNumOutputChannels());
+    scheduler.reset();
+
 }
 
 void GainTutorialAudioProcessor::releaseResources()
@@ -131,11 +129,10 @@ bool GainTutorialAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
     return true;
   #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    //mono and stereo, and surround and ambisonic layouts up to 16 channels
+    if (! ChannelLayouts::isSupported(layouts.getMainOutputChannelSet()))
         return false;
 
     // This checks if the input layout matches the output layout
@@ -156,20 +153,23 @@ void GainTutorialAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    //load in parameter states
-    auto phase = *phaseParam < 0.5f ? 1.0f : -1.0f;
-    mGain = *gainParam;
-    mGain = juce::Decibels::decibelsToGain(mGain) * phase;
+    //only meter while there's an editor open to show it
+    auto* activeMeter = meter.isActive() ? &meter : nullptr;
 
-    if (mGain == previousGain)
-    {
-        buffer.applyGain(mGain);
-    }
-    //if gain has changed, apply gain ramp to prevent clicks and pops
-    else
+    //parameters get read again every slice (32 samples, or up to the next MIDI event), so
+    //automation isn't stepped by however big the host's buffer is
+    scheduler.process(buffer.getNumSamples(), midiMessages, [&] (int startSample, int numSamples)
     {
-        buffer.applyGainRamp(0, buffer.getNumSamples(), previousGain, mGain);
-    }
+        //load in parameter states. the target only gets converted to a gain when they've moved
+        gainEngine.setTarget(paramValues.get(Param::Gain), paramValues.getBool(Param::InvertPhase));
+
+        //if gain or phase has changed it ramps there per sample to prevent clicks and pops, and carries
+        //on from wherever it got to next slice. once it's there it's just one multiply per sample
+        gainEngine.process(buffer, buffer.getNumChannels(), startSample, numSamples, activeMeter);
+    });
+
+    if (activeMeter != nullptr)
+        activeMeter->publish(buffer);
 
     ////g is std atomic float pointer for gain
     //auto gainParam = apvts.getRawParameterValue("GAIN");
@@ -233,18 +233,3 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new GainTutorialAudioProcessor();
 }
-
-//method to get parameter layout object (parameter and value pairs)
-juce::AudioProcessorValueTreeState::ParameterLayout GainTutorialAudioProcessor::createParameters()
-{
-    //vector (list) of pointers for parameter objects
-    // <> donates what type of objects the vector holds
-    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
-
-    //push_back method appends object to vector
-    //std::make_unique allocates memory for unique_ptr
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("GAIN", "Gain", -60.0f, 0.0f, -18.0f)); //gain parameter
-    params.push_back(std::make_unique<juce::AudioParameterBool>("INVERT_PHASE", "Invert Phase", false)); //invert phase parameter
-
-    return { params.begin(), params.end() };
-}
\ No newline at end of file
@@ -9,6 +9,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../shared/ChannelLayouts.h"
+#include "../../shared/ParameterTable.h"
+#include "../../shared/SubBlockScheduler.h"
+#include "GainEngine.h"
+#include "LevelMeter.h"
 
 //==============================================================================
 /**
@@ -62,13 +67,35 @@ public:
     //object for adding parameters
     juce::AudioProcessorValueTreeState apvts;
 
-private:
-    //method to get parameter layout object (parameter and value pairs)
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
-    float previousGain; 
+    //levels of the output, for the editor to read
+    LevelMeter& getMeter() noexcept { return meter; }
 
-    std::atomic<float>* phaseParam = nullptr;
-    std::atomic<float>* gainParam = nullptr;
+private:
+    //every parameter, order has to match parameterTable
+    enum class Param
+    {
+        Gain,
+        InvertPhase,
+    };
+
+    //IDs, names, ranges and defaults of the parameters. the layout apvts is made with and the
+    //cached handles both come from this
+    static constexpr std::array<ParameterTable::Spec, 2> parameterTable{ {
+        ParameterTable::floatParameter(Param::Gain, "GAIN", "Gain", -60.0f, 0.0f, -18.0f),
+        ParameterTable::boolParameter(Param::InvertPhase, "INVERT_PHASE", "Invert Phase", false),
+    } };
+
+    static_assert(ParameterTable::isValid(parameterTable), "parameterTable is out of order, has a repeated ID or a default outside its range");
+
+    //gain and phase ramp per sample (in dB), so moving the slider or flipping the phase doesn't click
+    GainEngine gainEngine;
+    //splits processBlock into control rate slices
+    SubBlockScheduler scheduler;
+    //peak, RMS and true peak, measured by gainEngine while it applies the gain
+    LevelMeter meter;
+
+    //parameter values, looked up once here instead of by ID in processBlock
+    ParameterTable::Handles<Param, parameterTable.size()> paramValues{ apvts, parameterTable };
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GainTutorialAudioProcessor)
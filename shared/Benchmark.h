@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Timing helpers for the benchmark console apps: how long a piece of
+    processing takes per sample, and running a whole processor at a given
+    layout and block size.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Benchmark
+{
+//==============================================================================
+//timing rounds, and how long each one runs for
+constexpr int rounds = 5;
+constexpr double secondsPerRound = 0.1;
+
+/**
+    Nanoseconds per sample of process(), which handles samplesPerCall
+    samples each time it's called. It gets called once to warm up, then
+    over and over for a few rounds, and the fastest round counts: anything
+    else the machine was doing only ever makes a round slower.
+*/
+template <typename Process>
+double nsPerSample(int samplesPerCall, Process&& process)
+{
+    process();
+
+    auto best = std::numeric_limits<double>::max();
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        auto seconds = 0.0;
+        int calls = 0;
+
+        do
+        {
+            process();
+            ++calls;
+            seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        }
+        while (seconds < secondsPerRound);
+
+        best = juce::jmin(best, seconds * 1.0e9 / ((double) calls * samplesPerCall));
+    }
+
+    return best;
+}
+
+//how much of one core something taking nsPerFrame a sample frame needs to keep up in real time
+inline double getCpuPercent(double nsPerFrame, double sampleRate = 48000.0)
+{
+    return nsPerFrame * sampleRate * 1.0e-7;
+}
+
+//reading the result back means the optimizer can't drop the work that made it
+inline void keep(const float* samples, int numSamples)
+{
+    static volatile float sink = 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+        sink = sink + samples[i];
+}
+
+//white noise at level, the same every time for the same seed
+inline void fillWithNoise(juce::AudioBuffer<float>& buffer, float level = 0.25f, juce::int64 seed = 1)
+{
+    juce::Random random(seed);
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        auto* samples = buffer.getWritePointer(channel);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            samples[i] = level * (2.0f * random.nextFloat() - 1.0f);
+    }
+}
+
+//==============================================================================
+//set a parameter to value (in its own range, not 0 to 1) by its ID
+inline void setParameter(juce::AudioProcessor& processor, const juce::String& parameterID, float value)
+{
+    for (auto* parameter : processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            if (ranged->paramID == parameterID)
+            {
+                ranged->setValueNotifyingHost(ranged->convertTo0to1(value));
+                return;
+            }
+        }
+    }
+
+    //no parameter with that ID
+    jassertfalse;
+}
+
+//main input and output both on channels, false if the processor doesn't take it
+inline bool setLayout(juce::AudioProcessor& processor, const juce::AudioChannelSet& channels)
+{
+    auto layout = processor.getBusesLayout();
+    layout.inputBuses.getReference(0) = channels;
+    layout.outputBuses.getReference(0) = channels;
+
+    return processor.setBusesLayout(layout);
+}
+
+/**
+    Nanoseconds per sample frame of processBlock() at blockSize, with
+    noise going in on every channel of the layout. The input gets copied in
+    fresh for every block (a memcpy, next to nothing beside processBlock)
+    so a processor that skips silence still has something to work on.
+*/
+inline double timeProcessor(juce::AudioProcessor& processor, const juce::AudioChannelSet& channels,
+                            int blockSize, double sampleRate = 48000.0)
+{
+    if (! setLayout(processor, channels))
+    {
+        jassertfalse;
+        return 0.0;
+    }
+
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto numChannels = channels.size();
+    juce::AudioBuffer<float> input(numChannels, blockSize), buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    fillWithNoise(input);
+
+    auto ns = nsPerSample(blockSize, [&]
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.copyFrom(channel, 0, input, channel, 0, blockSize);
+
+        processor.processBlock(buffer, midi);
+    });
+
+    keep(buffer.getReadPointer(0), blockSize);
+    processor.releaseResources();
+
+    return ns;
+}
+
+//==============================================================================
+//every layout the effects take (see ChannelLayouts::isSupported), narrowest first
+struct Layout
+{
+    const char* name;
+    juce::AudioChannelSet channels;
+};
+
+inline std::vector<Layout> getLayouts()
+{
+    return { { "mono", juce::AudioChannelSet::mono() },
+             { "stereo", juce::AudioChannelSet::stereo() },
+             { "5.1", juce::AudioChannelSet::create5point1() },
+             { "7.1.4", juce::AudioChannelSet::create7point1point4() },
+             { "ambisonic 3", juce::AudioChannelSet::ambisonic(3) } };
+}
+
+//timeProcessor() at every layout, as a table: per frame, per channel and how much of one core it needs
+inline void printLayoutScaling(juce::AudioProcessor& processor, int blockSize, double sampleRate = 48000.0)
+{
+    std::printf("%12s %9s %12s %14s %8s\n", "layout", "channels", "ns / frame", "ns / channel", "% core");
+
+    for (auto& layout : getLayouts())
+    {
+        auto ns = timeProcessor(processor, layout.channels, blockSize, sampleRate);
+        auto numChannels = layout.channels.size();
+
+        std::printf("%12s %9d %12.2f %14.2f %7.2f%%\n", layout.name, numChannels, ns, ns / numChannels,
+                    getCpuPercent(ns, sampleRate));
+    }
+}
+
+/**
+    timeProcessor() at channels with the processor's PARALLEL parameter
+    off and then on, for each block size, as a table with the speedup.
+    With no cores to spare there aren't any workers and both are serial.
+*/
+inline void printParallelSpeedup(juce::AudioProcessor& processor, const juce::AudioChannelSet& channels,
+                                 std::initializer_list<int> blockSizes, double sampleRate = 48000.0)
+{
+    std::printf("%8s %12s %12s %9s\n", "block", "serial", "parallel", "speedup");
+
+    for (auto blockSize : blockSizes)
+    {
+        setParameter(processor, "PARALLEL", 0.0f);
+        auto serial = timeProcessor(processor, channels, blockSize, sampleRate);
+
+        setParameter(processor, "PARALLEL", 1.0f);
+        auto parallel = timeProcessor(processor, channels, blockSize, sampleRate);
+
+        std::printf("%8d %12.2f %12.2f %8.2fx\n", blockSize, serial, parallel, serial / parallel);
+    }
+
+    setParameter(processor, "PARALLEL", 0.0f);
+}
+}
@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    ChannelLayouts.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    The bus layouts the effects take, from mono up to 7.1.4 surround and
+    third order ambisonics.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace ChannelLayouts
+{
+
+//==============================================================================
+/**
+    Mono, stereo, 5.1, 7.1.4 or third order ambisonics (16 channels).
+
+    Every effect processes its channels the same way whatever they're
+    called, so which layouts it takes only comes down to how many channels
+    it was prepared for. This keeps the list in one place for every
+    isBusesLayoutSupported().
+*/
+inline bool isSupported(const juce::AudioChannelSet& set)
+{
+    return set == juce::AudioChannelSet::mono()
+        || set == juce::AudioChannelSet::stereo()
+        || set == juce::AudioChannelSet::create5point1()
+        || set == juce::AudioChannelSet::create7point1point4()
+        || set == juce::AudioChannelSet::ambisonic(3);
+}
+
+}
@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+    ChannelWorkers.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Small pool of real time threads that share a block's channels out with
+    the audio thread, for layouts too wide for one core.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    run() splits some work into numbered tasks, and the audio thread and
+    the workers all take tasks until there are none left. The audio thread
+    then waits for the ones the workers took, and returns.
+
+    Nothing allocates, and the only lock is inside notify(), held for a
+    moment when a worker has gone to sleep. A job is one 64 bit atomic: which job it
+    is, how many tasks it has and the next task to take. Taking a task is a
+    compare and swap on it, so a worker that's late for one job can never
+    take a task from the next. The audio thread counts finished tasks down
+    with another atomic and spins until it gets to 0, which it can only be
+    kept waiting on by tasks a worker has actually started.
+
+    Workers spin (yielding) for spinMs after their last task, which is well
+    under a block, so they can pick up the rest of the same block's tasks.
+    After that they wait on their thread's event and run() wakes them with
+    notify() when a job comes in, so nothing is left spinning between
+    blocks. Waking takes a moment, but the audio thread takes tasks as
+    well, so if the workers are asleep or busy everything still gets done
+    on the audio thread, just not in parallel.
+
+    Each worker is pinned to its own core, starting from the second one,
+    and is started as a real time thread (falling back to the highest
+    normal priority if the system won't allow one).
+*/
+class ChannelWorkers
+{
+public:
+    static constexpr int maxWorkers = 3;
+    //the workers and the audio thread
+    static constexpr int maxTasks = maxWorkers + 1;
+
+    ChannelWorkers() = default;
+
+    ~ChannelWorkers()
+    {
+        stop();
+    }
+
+    //as many workers as there are cores to spare, up to maxWorkers
+    static int getAvailableWorkers()
+    {
+        return juce::jlimit(0, maxWorkers, juce::SystemStats::getNumCpus() - 1);
+    }
+
+    //start numWorkers threads, stopping any that were already going. never on the audio thread
+    void start(int numWorkers)
+    {
+        stop();
+        numWorkers = juce::jlimit(0, maxWorkers, numWorkers);
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            workers[(size_t) i] = std::make_unique<Worker>(*this, i + 1);
+
+            if (! workers[(size_t) i]->startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(10)))
+                workers[(size_t) i]->startThread(juce::Thread::Priority::highest);
+        }
+
+        numStarted = numWorkers;
+    }
+
+    void stop()
+    {
+        for (auto& worker : workers)
+            if (worker != nullptr)
+                worker->stopThread(1000);
+
+        for (auto& worker : workers)
+            worker.reset();
+
+        numStarted = 0;
+    }
+
+    int getNumWorkers() const noexcept { return numStarted; }
+
+    //task(0) to task(numTasks - 1) on the workers and this thread, back once they've all finished.
+    //without workers (or with only one task) it's just a loop
+    template <typename Task>
+    void run(int numTasks, Task&& task) noexcept
+    {
+        jassert(numTasks <= 0xffff);
+
+        if (numStarted == 0 || numTasks <= 1)
+        {
+            for (int i = 0; i < numTasks; ++i)
+                task(i);
+
+            return;
+        }
+
+        context = &task;
+        invoke = [] (void* taskContext, int index) { (*static_cast<std::remove_reference_t<Task>*>(taskContext))(index); };
+        pending.store(numTasks, std::memory_order_relaxed);
+
+        generation = (generation + 1) & 0xffffffff;
+        job.store((generation << 32) | ((std::uint64_t) numTasks << 16), std::memory_order_release);
+
+        //wake any workers that have gone to sleep. the fence pairs with the one in Worker::run(), so
+        //either this sees it asleep or it sees the job before it goes to sleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        for (int i = 0; i < numStarted; ++i)
+            if (workers[(size_t) i]->asleep.load(std::memory_order_relaxed))
+                workers[(size_t) i]->notify();
+
+        for (int index; claim(index);)
+        {
+            task(index);
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        while (pending.load(std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+    }
+
+private:
+    //how long a worker keeps spinning after its last task, a fraction of even a short block
+    static constexpr double spinMs = 0.2;
+
+    struct Worker  : public juce::Thread
+    {
+        Worker(ChannelWorkers& ownerToUse, int coreToUse)
+            : juce::Thread("Channel Worker " + juce::String(coreToUse)), owner(ownerToUse), core(coreToUse)
+        {
+        }
+
+        void run() override
+        {
+            if (core < 32 && core < juce::SystemStats::getNumCpus())
+                juce::Thread::setCurrentThreadAffinityMask((juce::uint32) 1 << core);
+
+            auto lastTaskMs = juce::Time::getMillisecondCounterHiRes();
+
+            while (! threadShouldExit())
+            {
+                int index;
+
+                if (owner.claim(index))
+                {
+                    owner.invoke(owner.context, index);
+                    owner.pending.fetch_sub(1, std::memory_order_release);
+                    lastTaskMs = juce::Time::getMillisecondCounterHiRes();
+                    continue;
+                }
+
+                if (juce::Time::getMillisecondCounterHiRes() - lastTaskMs < spinMs)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                //nothing to do, sleep until run() has another job (stopThread() wakes it too)
+                asleep.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (! owner.hasTask())
+                    wait(-1);
+
+                asleep.store(false, std::memory_order_relaxed);
+                lastTaskMs = juce::Time::getMillisecondCounterHiRes();
+            }
+        }
+
+        ChannelWorkers& owner;
+        int core;
+        //set while it's waiting for run() to wake it
+        std::atomic<bool> asleep{ false };
+    };
+
+    //true if the current job has tasks nobody has taken yet
+    bool hasTask() const noexcept
+    {
+        auto word = job.load(std::memory_order_acquire);
+        return (int) (word & 0xffff) < (int) ((word >> 16) & 0xffff);
+    }
+
+    //take the next task of the current job, false if they've all been taken
+    bool claim(int& index) noexcept
+    {
+        auto word = job.load(std::memory_order_acquire);
+
+        for (;;)
+        {
+            auto next = (int) (word & 0xffff);
+            auto count = (int) ((word >> 16) & 0xffff);
+
+            if (next >= count)
+                return false;
+
+            if (job.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                index = next;
+                return true;
+            }
+        }
+    }
+
+    std::array<std::unique_ptr<Worker>, maxWorkers> workers;
+    int numStarted{ 0 };
+
+    //job number << 32 | number of tasks << 16 | next task
+    std::atomic<std::uint64_t> job{ 0 };
+    std::uint64_t generation{ 0 };
+    //tasks not finished yet
+    std::atomic<int> pending{ 0 };
+
+    //the task run() was given, only read by workers that have taken one of its tasks
+    void* context{ nullptr };
+    void (*invoke)(void*, int){ nullptr };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelWorkers)
+};
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    ParameterTable.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    One compile-time table of parameters per plugin, which makes the
+    parameter layout and the cached handles the audio thread reads from.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace ParameterTable
+{
+
+enum class Kind
+{
+    Float,
+    Int,
+    Bool,
+    Choice,
+};
+
+//==============================================================================
+/**
+    Everything about one parameter. All constexpr, so a processor's whole
+    table is a compile-time constant: ranges can be used in other constants
+    (like buffer sizes) and mistakes in the table stop the build.
+
+    index is the parameter's Id enum value, so the table can check it's in
+    the same order as the enum.
+*/
+struct Spec
+{
+    int index;
+    const char* id;
+    const char* name;
+    Kind kind;
+    float min;
+    float max;
+    float defaultValue;
+    //float only, below 1 gives more of the range to the low end (for frequencies)
+    float skew;
+    const char* const* choices;
+    int numChoices;
+    //false for settings that can only change off the audio thread (like ones that move the latency),
+    //so the host doesn't offer them for automation
+    bool automatable{ true };
+};
+
+template <typename Id>
+constexpr Spec floatParameter(Id index, const char* id, const char* name, float min, float max, float defaultValue, float skew = 1.0f)
+{
+    return { (int) index, id, name, Kind::Float, min, max, defaultValue, skew, nullptr, 0 };
+}
+
+template <typename Id>
+constexpr Spec intParameter(Id index, const char* id, const char* name, int min, int max, int defaultValue)
+{
+    return { (int) index, id, name, Kind::Int, (float) min, (float) max, (float) defaultValue, 1.0f, nullptr, 0 };
+}
+
+template <typename Id>
+constexpr Spec boolParameter(Id index, const char* id, const char* name, bool defaultValue)
+{
+    return { (int) index, id, name, Kind::Bool, 0.0f, 1.0f, defaultValue ? 1.0f : 0.0f, 1.0f, nullptr, 0 };
+}
+
+//choices is a static array of names, in the order of the enum the parameter gets read as
+template <typename Id, size_t numChoices>
+constexpr Spec choiceParameter(Id index, const char* id, const char* name, const char* const (&choices)[numChoices], int defaultIndex)
+{
+    return { (int) index, id, name, Kind::Choice, 0.0f, (float) (numChoices - 1), (float) defaultIndex, 1.0f, choices, (int) numChoices };
+}
+
+//the same parameter, but one the host can't automate
+constexpr Spec notAutomatable(Spec spec)
+{
+    spec.automatable = false;
+    return spec;
+}
+
+//==============================================================================
+//checks for the static_assert every table gets
+
+constexpr bool isSameString(const char* a, const char* b)
+{
+    for (; *a != 0 && *a == *b; ++a, ++b) {}
+    return *a == *b;
+}
+
+//every entry is where its Id says it is
+template <size_t size>
+constexpr bool isInOrder(const std::array<Spec, size>& table)
+{
+    for (size_t i = 0; i < size; ++i)
+        if (table[i].index != (int) i)
+            return false;
+
+    return true;
+}
+
+//no two parameters share an ID, the host would only see one of them
+template <size_t size>
+constexpr bool hasUniqueIds(const std::array<Spec, size>& table)
+{
+    for (size_t i = 0; i < size; ++i)
+        for (size_t j = i + 1; j < size; ++j)
+            if (isSameString(table[i].id, table[j].id))
+                return false;
+
+    return true;
+}
+
+//every default is inside its range, and skews are positive
+template <size_t size>
+constexpr bool hasValidRanges(const std::array<Spec, size>& table)
+{
+    for (auto& spec : table)
+        if (! (spec.min < spec.max && spec.min <= spec.defaultValue && spec.defaultValue <= spec.max && spec.skew > 0.0f))
+            return false;
+
+    return true;
+}
+
+template <size_t size>
+constexpr bool isValid(const std::array<Spec, size>& table)
+{
+    return isInOrder(table) && hasUniqueIds(table) && hasValidRanges(table);
+}
+
+//==============================================================================
+inline std::unique_ptr<juce::RangedAudioParameter> createParameter(const Spec& spec)
+{
+    switch (spec.kind)
+    {
+        case Kind::Int:
+            return std::make_unique<juce::AudioParameterInt>(spec.id, spec.name, (int) spec.min, (int) spec.max, (int) spec.defaultValue,
+                                                             juce::AudioParameterIntAttributes().withAutomatable(spec.automatable));
+
+        case Kind::Bool:
+            return std::make_unique<juce::AudioParameterBool>(spec.id, spec.name, spec.defaultValue >= 0.5f,
+                                                              juce::AudioParameterBoolAttributes().withAutomatable(spec.automatable));
+
+        case Kind::Choice:
+            return std::make_unique<juce::AudioParameterChoice>(spec.id, spec.name, juce::StringArray(spec.choices, spec.numChoices),
+                                                                (int) spec.defaultValue,
+                                                                juce::AudioParameterChoiceAttributes().withAutomatable(spec.automatable));
+
+        case Kind::Float:
+        default:
+            return std::make_unique<juce::AudioParameterFloat>(spec.id, spec.name, juce::NormalisableRange<float>(spec.min, spec.max, 0.0f, spec.skew),
+                                                               spec.defaultValue,
+                                                               juce::AudioParameterFloatAttributes().withAutomatable(spec.automatable));
+    }
+}
+
+//the layout for the AudioProcessorValueTreeState, in table order
+template <size_t size>
+juce::AudioProcessorValueTreeState::ParameterLayout createLayout(const std::array<Spec, size>& table)
+{
+    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+
+    for (auto& spec : table)
+        params.push_back(createParameter(spec));
+
+    return { params.begin(), params.end() };
+}
+
+//==============================================================================
+/**
+    The value of every parameter in the table, looked up by ID once when the
+    processor is made. After that reading one is an array index and an
+    atomic load, so the audio thread never searches for a parameter by name.
+*/
+template <typename Id, size_t size>
+class Handles
+{
+public:
+    Handles(const juce::AudioProcessorValueTreeState& state, const std::array<Spec, size>& table)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            handles[i] = state.getRawParameterValue(table[i].id);
+            //the layout wasn't made from this table
+            jassert(handles[i] != nullptr);
+        }
+    }
+
+    float get(Id id) const noexcept { return handles[(size_t) id]->load(std::memory_order_relaxed); }
+    int getInt(Id id) const noexcept { return (int) get(id); }
+    bool getBool(Id id) const noexcept { return get(id) >= 0.5f; }
+
+    //choice parameters, as the enum their choices are in the order of
+    template <typename Enum>
+    Enum getChoice(Id id) const noexcept { return (Enum) getInt(id); }
+
+private:
+    std::array<std::atomic<float>*, size> handles{};
+
+    JUCE_DECLARE_NON_COPYABLE (Handles)
+};
+
+}
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    Smoothing.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Parameter smoothers that fill a whole block of values in one call, and
+    say when they've settled so the constant value can be used instead.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Smoothing
+{
+
+enum class Method
+{
+    //same step every sample, reaches the target exactly at the end of the ramp
+    Linear,
+    //same ratio every sample (straight line in dB), values have to stay above 0
+    Multiplicative,
+    //one pole, fast at first and slowing down, gets within -60 dB of the step in the ramp time
+    Exponential,
+};
+
+//==============================================================================
+/**
+    Every method works out how many samples it needs when the target is set,
+    so they all settle on a countdown and snap to the target exactly at the
+    end. isSettled() is then one compare, and a settled smoother fills
+    nothing: the caller uses getCurrentValue() for the whole block, so
+    holding still costs nothing per sample.
+
+    fill() writes the values in a form without a dependency from one sample
+    to the next (start + step * n, or offset + scale * ratio^n with the
+    powers built 8 at a time), so the compiler can vectorize it.
+*/
+template <Method method>
+class Smoother
+{
+public:
+    explicit Smoother(float initialValue = 0.0f) noexcept
+        : current(initialValue), target(initialValue) {}
+
+    void reset(double sampleRate, double rampSeconds) noexcept
+    {
+        rampLength = juce::jmax(0, (int) std::floor(sampleRate * rampSeconds));
+        setCurrentAndTargetValue(target);
+    }
+
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        current = target = newValue;
+        countdown = 0;
+    }
+
+    void setTargetValue(float newValue) noexcept
+    {
+        if (newValue == target)
+            return;
+
+        target = newValue;
+
+        if (rampLength == 0 || ! canRamp())
+        {
+            setCurrentAndTargetValue(newValue);
+            return;
+        }
+
+        countdown = rampLength;
+
+        if constexpr (method == Method::Linear)
+        {
+            step = (target - current) / (float) countdown;
+        }
+        else if constexpr (method == Method::Multiplicative)
+        {
+            step = std::exp(std::log(target / current) / (float) countdown);
+        }
+        else
+        {
+            //a ramp always takes rampLength samples to get from a full step to -60 dB, so a
+            //small change settles sooner: it stops once it's within threshold of the target
+            step = std::pow(0.001f, 1.0f / (float) rampLength);
+
+            auto distance = std::abs(target - current);
+            auto threshold = 1.0e-5f * juce::jmax(1.0f, std::abs(target));
+
+            if (distance <= threshold)
+                setCurrentAndTargetValue(newValue);
+            else
+                countdown = juce::jmin(rampLength, (int) std::ceil(std::log(threshold / distance) / std::log(step)));
+        }
+    }
+
+    float getCurrentValue() const noexcept { return current; }
+    float getTargetValue() const noexcept { return target; }
+    bool isSettled() const noexcept { return countdown == 0; }
+
+    float getNextValue() noexcept
+    {
+        if (countdown == 0)
+            return target;
+
+        if (--countdown == 0)
+            current = target;
+        else if constexpr (method == Method::Linear)
+            current += step;
+        else if constexpr (method == Method::Multiplicative)
+            current *= step;
+        else
+            current = target + (current - target) * step;
+
+        return current;
+    }
+
+    void skip(int numSamples) noexcept
+    {
+        if (numSamples >= countdown)
+        {
+            setCurrentAndTargetValue(target);
+            return;
+        }
+
+        countdown -= numSamples;
+
+        if constexpr (method == Method::Linear)
+            current += step * (float) numSamples;
+        else if constexpr (method == Method::Multiplicative)
+            current *= std::pow(step, (float) numSamples);
+        else
+            current = target + (current - target) * std::pow(step, (float) numSamples);
+    }
+
+    //the next numSamples values into destination. returns false without writing anything
+    //if it's settled, then getCurrentValue() is the value for the whole block
+    bool fill(float* destination, int numSamples) noexcept
+    {
+        if (countdown == 0)
+            return false;
+
+        auto numRamping = juce::jmin(numSamples, countdown);
+
+        if constexpr (method == Method::Linear)
+        {
+            for (int i = 0; i < numRamping; ++i)
+                destination[i] = current + step * (float) (i + 1);
+        }
+        else
+        {
+            //multiplicative is current * step^n, exponential is target + (current - target) * step^n
+            fillPowers(destination, numRamping);
+
+            auto offset = method == Method::Multiplicative ? 0.0f : target;
+            auto scale = method == Method::Multiplicative ? current : current - target;
+
+            for (int i = 0; i < numRamping; ++i)
+                destination[i] = offset + scale * destination[i];
+        }
+
+        countdown -= numRamping;
+        current = countdown == 0 ? target : destination[numRamping - 1];
+
+        if (countdown == 0)
+            juce::FloatVectorOperations::fill(destination + numRamping - 1, target, numSamples - numRamping + 1);
+
+        return true;
+    }
+
+private:
+    bool canRamp() const noexcept
+    {
+        //a ratio can't get to or across 0
+        if constexpr (method == Method::Multiplicative)
+            return current > 0.0f && target > 0.0f;
+
+        return true;
+    }
+
+    //destination[i] = step^(i + 1). the first 8 by hand, then each one is the one 8 before it
+    //times step^8, which keeps the chain of multiplies short and vectorizes 8 wide
+    void fillPowers(float* destination, int numSamples) const noexcept
+    {
+        auto power = 1.0f;
+
+        for (int i = 0; i < juce::jmin(8, numSamples); ++i)
+            destination[i] = (power *= step);
+
+        if (numSamples <= 8)
+            return;
+
+        auto step8 = destination[7];
+
+        for (int i = 8; i < numSamples; ++i)
+            destination[i] = destination[i - 8] * step8;
+    }
+
+    float current;
+    float target;
+    //per sample increment (linear) or ratio (the others)
+    float step{ 0.0f };
+    int countdown{ 0 };
+    int rampLength{ 0 };
+};
+
+}
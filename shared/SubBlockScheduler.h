@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    SubBlockScheduler.h
+    Created: 18 Oct 2026
+    Author:  Swansonge
+
+    Splits a host block into short slices on a fixed control-rate grid and
+    at every MIDI event, so parameters get read more than once per block.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    The grid counts from when the scheduler was reset, not from the start of
+    each host block, so a slice boundary lands every gridSize samples however
+    the host chops the audio up: parameters are picked up at the same
+    resolution with 32 or 2048 sample buffers. Slices also end at every
+    event in the block's MidiBuffer.
+
+    Nothing gets copied: the callback gets a start sample and a length into
+    the host buffer, and getSlice() makes a buffer that points into it.
+*/
+class SubBlockScheduler
+{
+public:
+    static constexpr int defaultGridSize = 32;
+
+    explicit SubBlockScheduler(int gridSize = defaultGridSize) noexcept
+    {
+        setGridSize(gridSize);
+    }
+
+    void setGridSize(int newGridSize) noexcept { gridSize = juce::jmax(1, newGridSize); }
+    int getGridSize() const noexcept { return gridSize; }
+
+    //start the grid again, e.g. from prepareToPlay
+    void reset() noexcept { position = 0; }
+
+    //calls callback(startSample, numSamples) for each slice of a numSamples long block, in order
+    template <typename Callback>
+    void process(int numSamples, const juce::MidiBuffer& midi, Callback&& callback)
+    {
+        auto event = midi.begin();
+
+        for (int start = 0; start < numSamples;)
+        {
+            auto length = gridSize - (int) (position % gridSize);
+
+            //an event at the start of this slice is already on a boundary
+            while (event != midi.end() && (*event).samplePosition <= start)
+                ++event;
+
+            if (event != midi.end())
+                length = juce::jmin(length, (*event).samplePosition - start);
+
+            length = juce::jmin(length, numSamples - start);
+            callback(start, length);
+
+            start += length;
+            position += length;
+        }
+    }
+
+    //numSamples of buffer from startSample, sharing buffer's memory
+    static juce::AudioBuffer<float> getSlice(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+    {
+        return { buffer.getArrayOfWritePointers(), buffer.getNumChannels(), startSample, numSamples };
+    }
+
+private:
+    int gridSize{ defaultGridSize };
+    //samples since reset, for where the grid lines are
+    juce::int64 position{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SubBlockScheduler)
+};